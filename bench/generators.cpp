@@ -0,0 +1,85 @@
+#include "generators.h"
+#include <algorithm>
+#include <random>
+
+namespace bench {
+
+void make_config(workload const& size, unit_test::ConfigParserMock* config)
+{
+   std::vector<Logalizer::Config::translation> translations;
+   for (std::size_t i = 0; i < size.translations; ++i) {
+      Logalizer::Config::translation tr;
+      tr.category = "bench";
+      tr.patterns.push_back("event" + std::to_string(i) + " ");
+      for (std::size_t k = 1; k < size.patterns; ++k) {
+         tr.patterns.push_back("k" + std::to_string(i) + "_" + std::to_string(k));
+      }
+      tr.variables = {{"id=", ";"}, {"value=", "ms"}};
+      tr.print = "event" + std::to_string(i) + " ${1} took ${2} x${count}";
+      translations.push_back(tr);
+   }
+   config->set_translations(translations);
+
+   std::vector<std::string> delete_lines;
+   std::vector<std::string> blacklists;
+   std::vector<Logalizer::Config::replacement> replace_words;
+   for (std::size_t k = 0; k < size.patterns; ++k) {
+      delete_lines.push_back("drop" + std::to_string(k) + " ");
+      blacklists.push_back("noise" + std::to_string(k) + " ");
+      replace_words.emplace_back("rw" + std::to_string(k) + " ", "RW ");
+   }
+   replace_words.emplace_back("state=([a-z]*)", "state=[$1]");
+   config->set_delete_lines(delete_lines);
+   config->set_delete_lines_linear({*Logalizer::Config::LinearRegex::compile("heartbeat [0-9]*$")});
+   config->set_blacklists(blacklists);
+   config->set_replace_words(replace_words);
+
+   std::vector<Logalizer::Config::pair> pairs;
+   for (std::size_t i = 0; i < size.pairs; ++i) {
+      const std::size_t source = (2 * i) % std::max<std::size_t>(size.translations, 1);
+      const std::size_t with = (2 * i + 1) % std::max<std::size_t>(size.translations, 1);
+      pairs.push_back({"event" + std::to_string(source) + " ", "event" + std::to_string(with) + " ", "",
+                       "missing event" + std::to_string(with)});
+   }
+   config->set_pairs(pairs);
+}
+
+std::vector<std::string> make_lines(workload const& size, std::size_t count)
+{
+   std::minstd_rand random(42);
+   auto below = [&random](std::size_t limit) {
+      return static_cast<std::size_t>(random() % std::max<std::size_t>(limit, 1));
+   };
+
+   std::vector<std::string> lines;
+   lines.reserve(count);
+   for (std::size_t n = 0; n < count; ++n) {
+      std::string line = "2024-03-01 10:15:" + std::to_string(10 + n % 50) + ".123 [INFO] module" +
+                         std::to_string(below(8)) + " ";
+      const std::size_t kind = below(32);
+      if (kind == 0) {
+         line += "noise" + std::to_string(below(size.patterns)) + " ";
+      }
+      if (kind < 2) {
+         line += "drop" + std::to_string(below(size.patterns)) + " ";
+      }
+      else if (kind < 3) {
+         line += "heartbeat " + std::to_string(n);
+         lines.push_back(std::move(line));
+         continue;
+      }
+
+      // the upper half of the event numbers has no translation
+      const std::size_t event = below(2 * size.translations);
+      line += "event" + std::to_string(event) + " ";
+      for (std::size_t k = 1; k < size.patterns; ++k) {
+         line += "k" + std::to_string(event) + "_" + std::to_string(k) + " ";
+      }
+      line += "rw" + std::to_string(below(size.patterns)) + " id=" + std::to_string(below(1000)) +
+              "; state=ok value=" + std::to_string(below(500)) + "ms";
+      lines.push_back(std::move(line));
+   }
+   return lines;
+}
+
+}  // namespace bench
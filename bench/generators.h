@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "configparser_mock.h"
+
+namespace bench {
+
+/**
+ * @brief Shape of a synthetic configuration and the log lines made for it
+ *
+ */
+struct workload {
+   std::size_t translations = 16;  /// number of translations
+   std::size_t patterns = 2;       /// patterns per translation, and entries per filter list
+   std::size_t pairs = 4;          /// number of pairs
+};
+
+/**
+ * @brief Fill config with translations, delete_lines, blacklist, replace_words and pairs of the given shape
+ *
+ * Translation i matches lines containing "event<i> " and its extra patterns "k<i>_<n>".
+ * Every translation captures the id and the value of a line.
+ *
+ * @param size
+ * @param config
+ */
+void make_config(workload const& size, unit_test::ConfigParserMock* config);
+
+/**
+ * @brief Generate log lines for a configuration made by make_config with the same size
+ *
+ * About half of the lines match a translation, one in sixteen is deleted and one in thirty two
+ * is blacklisted. The lines are the same for every call with the same arguments.
+ *
+ * @param size
+ * @param count number of lines
+ * @return std::vector<std::string>
+ */
+[[nodiscard]] std::vector<std::string> make_lines(workload const& size, std::size_t count);
+
+}  // namespace bench
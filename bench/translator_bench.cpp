@@ -0,0 +1,223 @@
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "configparser_mock.h"
+#include "generators.h"
+
+namespace fs = std::filesystem;
+using namespace Logalizer::Config;
+using unit_test::ConfigParserMock;
+using unit_test::TranslatorTesterProxy;
+
+namespace {
+
+constexpr std::size_t lines_per_run = 4096;
+
+bench::workload shape(benchmark::State const& state)
+{
+   bench::workload size;
+   size.translations = static_cast<std::size_t>(state.range(0));
+   size.patterns = static_cast<std::size_t>(state.range(1));
+   return size;
+}
+
+std::string bench_file(std::string const& name)
+{
+   return (fs::temp_directory_path() / name).string();
+}
+
+/**
+ * @brief Translations of lines, as add_translation receives them
+ *
+ */
+std::vector<std::string> translated_lines(ConfigParserMock const& config, std::vector<std::string> const& lines)
+{
+   TranslatorTesterProxy tr(Translator{config});
+   std::vector<std::string> translated;
+   for (auto const& line : lines) {
+      const auto match = tr.get_matching_translator(line);
+      if (match == cend(config.get_translations())) {
+         continue;
+      }
+      std::vector<std::string_view> values;
+      for (auto const& var : match->variable_searches) {
+         values.push_back(tr.capture_values(var, line));
+      }
+      translated.emplace_back(tr.fill_values_formatted(values, *match));
+   }
+   return translated;
+}
+
+void BM_is_deleted(benchmark::State& state)
+{
+   ConfigParserMock config;
+   bench::make_config(shape(state), &config);
+   const auto lines = bench::make_lines(shape(state), lines_per_run);
+   TranslatorTesterProxy tr(Translator{config});
+
+   for (auto _ : state) {
+      for (auto const& line : lines) {
+         benchmark::DoNotOptimize(tr.is_deleted(line));
+      }
+   }
+   state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(lines.size()));
+}
+
+void BM_replace_words(benchmark::State& state)
+{
+   ConfigParserMock config;
+   bench::make_config(shape(state), &config);
+   const auto lines = bench::make_lines(shape(state), lines_per_run);
+   TranslatorTesterProxy tr(Translator{config});
+
+   std::string line;
+   for (auto _ : state) {
+      for (auto const& input : lines) {
+         line = input;
+         tr.replace(&line);
+         benchmark::DoNotOptimize(line.data());
+      }
+   }
+   state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(lines.size()));
+}
+
+void BM_get_matching_translator(benchmark::State& state)
+{
+   ConfigParserMock config;
+   bench::make_config(shape(state), &config);
+   const auto lines = bench::make_lines(shape(state), lines_per_run);
+   TranslatorTesterProxy tr(Translator{config});
+
+   for (auto _ : state) {
+      for (auto const& line : lines) {
+         benchmark::DoNotOptimize(tr.get_matching_translator(line));
+      }
+   }
+   state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(lines.size()));
+}
+
+void BM_capture_values(benchmark::State& state)
+{
+   ConfigParserMock config;
+   bench::make_config(bench::workload{}, &config);
+   const auto lines = bench::make_lines(bench::workload{}, lines_per_run);
+   TranslatorTesterProxy tr(Translator{config});
+   const auto& variables = config.get_translations().front().variable_searches;
+
+   for (auto _ : state) {
+      for (auto const& line : lines) {
+         for (auto const& var : variables) {
+            benchmark::DoNotOptimize(tr.capture_values(var, line));
+         }
+      }
+   }
+   state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(lines.size()));
+}
+
+void BM_fill_values_formatted(benchmark::State& state)
+{
+   ConfigParserMock config;
+   bench::workload size;
+   size.translations = static_cast<std::size_t>(state.range(0));
+   bench::make_config(size, &config);
+   TranslatorTesterProxy tr(Translator{config});
+   const std::vector<std::string_view> values = {"4711", "250"};
+
+   for (auto _ : state) {
+      for (auto const& translation : config.get_translations()) {
+         benchmark::DoNotOptimize(tr.fill_values_formatted(values, translation).data());
+      }
+   }
+   state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(config.get_translations().size()));
+}
+
+void BM_add_translation(benchmark::State& state)
+{
+   const auto duplicates = static_cast<duplicates_t>(state.range(0));
+   ConfigParserMock config;
+   bench::workload size;
+   bench::make_config(size, &config);
+   config.set_translation_file(bench_file("logalizer_bench_add.txt"));
+   std::vector<translation> translations = config.get_translations();
+   for (auto& tr : translations) {
+      tr.duplicates = duplicates;
+   }
+   config.set_translations(translations);
+   const auto translated = translated_lines(config, bench::make_lines(size, static_cast<std::size_t>(state.range(1))));
+   TranslatorTesterProxy tr(Translator{config});
+
+   for (auto _ : state) {
+      tr.open_translation_file();
+      for (auto const& translation : translated) {
+         tr.add_translation(translation, duplicates);
+      }
+      tr.write_translation_file();
+   }
+   state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(translated.size()));
+}
+
+void BM_update_count(benchmark::State& state)
+{
+   ConfigParserMock config;
+   bench::make_config(bench::workload{}, &config);
+   const auto translated = translated_lines(config, bench::make_lines(bench::workload{}, lines_per_run));
+   TranslatorTesterProxy tr(Translator{config});
+
+   for (auto _ : state) {
+      for (auto const& input : translated) {
+         benchmark::DoNotOptimize(tr.update_count(42, input).data());
+      }
+   }
+   state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(translated.size()));
+}
+
+void BM_validate_pairs(benchmark::State& state)
+{
+   ConfigParserMock config;
+   bench::workload size;
+   size.translations = 64;
+   size.pairs = static_cast<std::size_t>(state.range(0));
+   bench::make_config(size, &config);
+   const auto translated = translated_lines(config, bench::make_lines(size, lines_per_run));
+   TranslatorTesterProxy tr(Translator{config});
+
+   for (auto _ : state) {
+      benchmark::DoNotOptimize(tr.validate_pairs(translated));
+   }
+   state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(translated.size()));
+}
+
+void BM_translate_file(benchmark::State& state)
+{
+   ConfigParserMock config;
+   bench::make_config(bench::workload{}, &config);
+   config.set_translation_file(bench_file("logalizer_bench_translation.txt"));
+   std::string input;
+   for (auto const& line : bench::make_lines(bench::workload{}, static_cast<std::size_t>(state.range(0)))) {
+      input.append(line).push_back('\n');
+   }
+   const std::string input_file = bench_file("logalizer_bench_input.log");
+   TranslatorTesterProxy tr(Translator{config});
+
+   for (auto _ : state) {
+      state.PauseTiming();
+      std::ofstream(input_file, std::ios::binary) << input;
+      state.ResumeTiming();
+      tr.translate_file(input_file);
+   }
+   state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(input.size()));
+}
+
+}  // namespace
+
+BENCHMARK(BM_is_deleted)->ArgsProduct({{16}, {1, 8, 64}});
+BENCHMARK(BM_replace_words)->ArgsProduct({{16}, {1, 8, 64}});
+BENCHMARK(BM_get_matching_translator)->ArgsProduct({{8, 64, 512}, {1, 4}});
+BENCHMARK(BM_capture_values);
+BENCHMARK(BM_fill_values_formatted)->Arg(64);
+BENCHMARK(BM_add_translation)->ArgsProduct({{0, 1, 2, 3, 4}, {1 << 10, 1 << 14}});
+BENCHMARK(BM_update_count);
+BENCHMARK(BM_validate_pairs)->Arg(1)->Arg(16)->Arg(128);
+BENCHMARK(BM_translate_file)->Arg(1 << 12)->Arg(1 << 16);
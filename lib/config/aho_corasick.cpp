@@ -0,0 +1,207 @@
+#include "aho_corasick.h"
+#include <bit>
+#include <cstring>
+#include <queue>
+#include "compiled_config.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LOGALIZER_SSE2 1
+#endif
+
+namespace Logalizer::Config {
+
+AhoCorasick::AhoCorasick(std::vector<std::string> const& patterns) : patterns_(patterns.size())
+{
+   for (auto const& pattern : patterns) {
+      for (const char c : pattern) {
+         auto& cls = byte_class_[static_cast<unsigned char>(c)];
+         if (cls == 0) {
+            cls = static_cast<std::uint16_t>(classes_++);
+         }
+      }
+   }
+
+   // Build the trie, 0 marks a missing edge as no edge leads back to the root
+   next_.assign(classes_, 0);
+   output_.assign(1, 0);
+   std::vector<bool> terminal(1, false);
+   for (std::uint32_t id = 0; id < patterns.size(); ++id) {
+      std::uint32_t state = 0;
+      for (const char c : patterns[id]) {
+         const std::size_t edge = std::size_t{state} * classes_ + byte_class_[static_cast<unsigned char>(c)];
+         if (next_[edge] == 0) {
+            const auto added = static_cast<std::uint32_t>(output_.size());
+            next_[edge] = added;
+            next_.resize(next_.size() + classes_, 0);
+            output_.push_back(0);
+            terminal.push_back(false);
+         }
+         state = next_[edge];
+      }
+      if (state != 0 && !terminal[state]) {
+         terminal[state] = true;
+         output_[state] = id;
+      }
+   }
+
+   // Turn the trie into a complete automaton in breadth first order
+   const std::size_t states = output_.size();
+   std::vector<std::uint32_t> fail(states, 0);
+   first_output_.assign(states, 0);
+   output_link_.assign(states, 0);
+   std::queue<std::uint32_t> pending;
+   for (std::uint32_t cls = 0; cls < classes_; ++cls) {
+      if (const auto child = next_[cls]; child != 0) {
+         first_output_[child] = terminal[child] ? child : 0;
+         pending.push(child);
+      }
+   }
+   while (!pending.empty()) {
+      const std::uint32_t state = pending.front();
+      pending.pop();
+      for (std::uint32_t cls = 0; cls < classes_; ++cls) {
+         auto& edge = next_[std::size_t{state} * classes_ + cls];
+         const std::uint32_t fallback = next_[std::size_t{fail[state]} * classes_ + cls];
+         if (edge == 0) {
+            edge = fallback;
+            continue;
+         }
+         const std::uint32_t child = edge;
+         fail[child] = fallback;
+         output_link_[child] = terminal[fallback] ? fallback : output_link_[fallback];
+         first_output_[child] = terminal[child] ? child : output_link_[child];
+         pending.push(child);
+      }
+   }
+
+   std::size_t start_count = 0;
+   for (std::size_t byte = 0; byte < starts_.size(); ++byte) {
+      starts_[byte] = next_[byte_class_[byte]] != 0;
+      if (starts_[byte]) {
+         if (start_count < start_bytes_.size()) {
+            start_bytes_[start_count] = static_cast<char>(byte);
+         }
+         ++start_count;
+      }
+   }
+   if (start_count == 0) {
+      return;
+   }
+   if (start_count <= start_bytes_.size()) {
+      for (std::size_t fill = start_count; fill < start_bytes_.size(); ++fill) {
+         start_bytes_[fill] = start_bytes_[0];
+      }
+      skip_ = skip::bytes;
+      return;
+   }
+
+   // A byte whose successor leaves its depth one state through the failure link restarts at the
+   // successor, so it only needs to be walked when a pattern continues with that successor or the
+   // byte alone is a pattern
+   constexpr std::size_t byte_values = 256;
+   std::vector<std::uint64_t> pairs(byte_values * byte_values / 64, 0);
+   std::size_t pair_count = 0;
+   auto add_pair = [&pairs, &pair_count](std::size_t pair) {
+      auto& word = pairs[pair / 64];
+      const std::uint64_t bit = std::uint64_t{1} << (pair % 64);
+      pair_count += (word & bit) == 0 ? 1 : 0;
+      word |= bit;
+   };
+   for (auto const& pattern : patterns) {
+      if (pattern.empty()) {
+         continue;
+      }
+      const std::size_t first = static_cast<unsigned char>(pattern[0]) * byte_values;
+      if (pattern.size() == 1) {
+         for (std::size_t second = 0; second < byte_values; ++second) {
+            add_pair(first + second);
+         }
+      }
+      else {
+         add_pair(first + static_cast<unsigned char>(pattern[1]));
+      }
+   }
+   if (pair_count <= pairs.size() * 64 / 2) {
+      start_pairs_ = std::move(pairs);
+      skip_ = skip::pairs;
+   }
+   else if (start_count <= starts_.size() / 2) {
+      // with most bytes starting a pattern the table lookup saves nothing over the transition
+      skip_ = skip::table;
+   }
+}
+
+const char* AhoCorasick::skip_to_start(const char* begin, const char* end) const noexcept
+{
+   if (skip_ == skip::none) {
+      return begin;
+   }
+   if (skip_ == skip::bytes) {
+      if (start_bytes_[0] == start_bytes_[1] && start_bytes_[0] == start_bytes_[2]) {
+         const void* found = std::memchr(begin, start_bytes_[0], static_cast<std::size_t>(end - begin));
+         return (found == nullptr) ? end : static_cast<const char*>(found);
+      }
+#if defined(LOGALIZER_SSE2)
+      const __m128i first = _mm_set1_epi8(start_bytes_[0]);
+      const __m128i second = _mm_set1_epi8(start_bytes_[1]);
+      const __m128i third = _mm_set1_epi8(start_bytes_[2]);
+      for (; end - begin >= 16; begin += 16) {
+         const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+         const __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, first), _mm_cmpeq_epi8(block, second)),
+                                           _mm_cmpeq_epi8(block, third));
+         if (const int mask = _mm_movemask_epi8(hits); mask != 0) {
+            return begin + std::countr_zero(static_cast<unsigned>(mask));
+         }
+      }
+#endif
+   }
+   if (skip_ == skip::pairs) {
+      const std::uint64_t* pairs = start_pairs_.data();
+      for (; end - begin >= 2; ++begin) {
+         const std::size_t pair =
+             (std::size_t{static_cast<unsigned char>(begin[0])} << 8U) | static_cast<unsigned char>(begin[1]);
+         if (((pairs[pair / 64] >> (pair % 64)) & 1U) != 0) {
+            return begin;
+         }
+      }
+      // the last byte has no successor, it is checked on its own below
+   }
+   for (; begin != end && !starts_[static_cast<unsigned char>(*begin)]; ++begin) {
+   }
+   return begin;
+}
+
+void AhoCorasick::write(CompiledConfigWriter& out) const
+{
+   out.put_array(byte_class_);
+   out.put_value(classes_);
+   out.put_value(static_cast<std::uint64_t>(patterns_));
+   out.put_vector(next_);
+   out.put_vector(output_);
+   out.put_vector(first_output_);
+   out.put_vector(output_link_);
+   out.put_value(skip_);
+   out.put_array(starts_);
+   out.put_array(start_bytes_);
+   out.put_vector(start_pairs_);
+}
+
+AhoCorasick AhoCorasick::read(CompiledConfigReader& in)
+{
+   AhoCorasick automaton;
+   in.get_array(&automaton.byte_class_);
+   automaton.classes_ = in.get_value<std::uint32_t>();
+   automaton.patterns_ = static_cast<std::size_t>(in.get_value<std::uint64_t>());
+   automaton.next_ = in.get_vector<std::uint32_t>();
+   automaton.output_ = in.get_vector<std::uint32_t>();
+   automaton.first_output_ = in.get_vector<std::uint32_t>();
+   automaton.output_link_ = in.get_vector<std::uint32_t>();
+   automaton.skip_ = in.get_value<skip>();
+   in.get_array(&automaton.starts_);
+   in.get_array(&automaton.start_bytes_);
+   automaton.start_pairs_ = in.get_vector<std::uint64_t>();
+   return automaton;
+}
+
+}  // namespace Logalizer::Config
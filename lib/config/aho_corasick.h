@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Logalizer::Config {
+
+class CompiledConfigReader;
+class CompiledConfigWriter;
+
+/**
+ * @brief AhoCorasick finds every occurrence of a set of literal patterns in a single pass
+ *
+ * The automaton is compiled into a dense transition table over byte classes.
+ * Bytes that do not occur in any pattern share one class, so the table stays small even for
+ * hundreds of patterns.
+ *
+ * While the automaton is in its start state, bytes that cannot start a pattern are skipped without
+ * walking the table. With at most three distinct first bytes the skip compares 16 bytes at a time.
+ * With more, it looks up the byte together with the next one in a bigram bitmap, so a byte that
+ * starts a pattern is only walked when the following byte continues one.
+ *
+ * Patterns are identified by their position in the list given to the constructor.
+ * A pattern that is listed twice is reported with the id of its first entry.
+ * Empty patterns are never reported, callers have to treat them as always present.
+ */
+class AhoCorasick {
+  public:
+   AhoCorasick() = default;
+   explicit AhoCorasick(std::vector<std::string> const& patterns);
+
+   /**
+    * @brief Report every pattern occurrence in text
+    *
+    * on_match is called with the pattern id for every occurrence, in the order the occurrences end.
+    * Scanning stops early when on_match returns false.
+    *
+    * @param text
+    * @param on_match callable as bool(std::uint32_t pattern_id)
+    * @return false if on_match stopped the scan
+    */
+   template <class OnMatch>
+   bool scan(std::string_view text, OnMatch&& on_match) const
+   {
+      if (patterns_ == 0) {
+         return true;
+      }
+      std::uint32_t state = 0;
+      const std::uint32_t* next = next_.data();
+      const char* position = text.data();
+      const char* const end = position + text.size();
+      while (position != end) {
+         if (state == 0) {
+            position = skip_to_start(position, end);
+            if (position == end) {
+               break;
+            }
+         }
+         const auto c = static_cast<unsigned char>(*position++);
+         state = next[std::size_t{state} * classes_ + byte_class_[c]];
+         for (std::uint32_t s = first_output_[state]; s != 0; s = output_link_[s]) {
+            if (!on_match(static_cast<std::uint32_t>(output_[s]))) {
+               return false;
+            }
+         }
+      }
+      return true;
+   }
+
+   /**
+    * @brief Check if any pattern occurs in text
+    *
+    * @param text
+    * @return true if at least one pattern is found
+    */
+   [[nodiscard]] bool contains_any(std::string_view text) const
+   {
+      return !scan(text, [](std::uint32_t) { return false; });
+   }
+
+   /**
+    * @brief Number of patterns the automaton was built from
+    *
+    * @return std::size_t
+    */
+   [[nodiscard]] std::size_t size() const noexcept
+   {
+      return patterns_;
+   }
+
+   /**
+    * @brief Store the compiled tables, see ConfigParser::save_compiled
+    *
+    * @param out
+    */
+   void write(CompiledConfigWriter& out) const;
+
+   /**
+    * @brief Restore the tables stored with write
+    *
+    * @param in
+    * @return AhoCorasick as it was written
+    */
+   [[nodiscard]] static AhoCorasick read(CompiledConfigReader& in);
+
+  private:
+   enum class skip : std::uint8_t { none, bytes, table, pairs };
+
+   /**
+    * @brief Find the first byte in [begin, end) that leaves the start state
+    *
+    * @return end if there is none
+    */
+   [[nodiscard]] const char* skip_to_start(const char* begin, const char* end) const noexcept;
+
+   std::array<std::uint16_t, 256> byte_class_{};  /// byte -> class, 0 for bytes that are in no pattern
+   std::uint32_t classes_ = 1;
+   std::size_t patterns_ = 0;
+   std::vector<std::uint32_t> next_;          /// state * classes_ + class -> next state
+   std::vector<std::uint32_t> output_;        /// pattern ending in this state
+   std::vector<std::uint32_t> first_output_;  /// this state if a pattern ends here, else output_link_
+   std::vector<std::uint32_t> output_link_;   /// nearest proper suffix state with an output, 0 if none
+   skip skip_ = skip::none;
+   std::array<bool, 256> starts_{};  /// bytes that leave the start state
+   std::array<char, 3> start_bytes_{};  /// the bytes in starts_ when skip_ is skip::bytes, repeated to fill
+   std::vector<std::uint64_t> start_pairs_;  /// bit first * 256 + second is set if a match can start with them
+};
+
+}  // namespace Logalizer::Config
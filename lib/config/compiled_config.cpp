@@ -0,0 +1,313 @@
+#include "compiled_config.h"
+#include <array>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include "configparser.h"
+
+namespace fs = std::filesystem;
+
+namespace Logalizer::Config {
+
+namespace {
+constexpr std::string_view magic = "LZCFG01\n";
+// bump whenever anything written by save_compiled or a matcher changes
+constexpr std::uint32_t format_version = 2;
+constexpr std::size_t table_alignment = 8;
+
+std::uint32_t layout()
+{
+   // the tables are stored as they are in memory
+   const std::uint32_t little = std::endian::native == std::endian::little ? 1 : 0;
+   return little | static_cast<std::uint32_t>(sizeof(std::size_t) << 8U) |
+          static_cast<std::uint32_t>(sizeof(unsigned) << 16U);
+}
+
+std::uint64_t checksum(std::string_view data)
+{
+   // FNV-1a, enough to tell a damaged or truncated file
+   std::uint64_t hash = 0xcbf29ce484222325ULL;
+   for (const char c : data) {
+      hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3ULL;
+   }
+   return hash;
+}
+
+struct header {
+   std::array<char, magic.size()> tag{};
+   std::uint32_t version = 0;
+   std::uint32_t layout = 0;
+   std::uint64_t size = 0;
+   std::uint64_t checksum = 0;
+};
+
+bool newer_than_sources(std::string const& file_name, std::vector<std::string> const& sources)
+{
+   std::error_code error;
+   const auto compiled = fs::last_write_time(file_name, error);
+   if (error) {
+      return false;
+   }
+   for (auto const& source : sources) {
+      const auto modified = fs::last_write_time(source, error);
+      if (error || modified > compiled) {
+         return false;
+      }
+   }
+   return true;
+}
+}  // namespace
+
+void CompiledConfigWriter::put_string(std::string_view text)
+{
+   put_value(static_cast<std::uint64_t>(text.size()));
+   append(text.data(), text.size());
+}
+
+void CompiledConfigWriter::put_strings(std::vector<std::string> const& texts)
+{
+   put_value(static_cast<std::uint64_t>(texts.size()));
+   for (auto const& text : texts) {
+      put_string(text);
+   }
+}
+
+void CompiledConfigWriter::append(void const* data, std::size_t size)
+{
+   data_.append(static_cast<char const*>(data), size);
+}
+
+void CompiledConfigWriter::align()
+{
+   data_.resize((data_.size() + table_alignment - 1) / table_alignment * table_alignment, '\0');
+}
+
+std::string CompiledConfigReader::get_string()
+{
+   const auto size = get_value<std::uint64_t>();
+   check(size, 1);
+   std::string text(data_.substr(position_, static_cast<std::size_t>(size)));
+   position_ += text.size();
+   return text;
+}
+
+std::vector<std::string> CompiledConfigReader::get_strings()
+{
+   const auto count = get_value<std::uint64_t>();
+   // every string takes at least its size
+   check(count, sizeof(std::uint64_t));
+   std::vector<std::string> texts;
+   texts.reserve(static_cast<std::size_t>(count));
+   for (std::uint64_t i = 0; i < count; ++i) {
+      texts.push_back(get_string());
+   }
+   return texts;
+}
+
+void CompiledConfigReader::check(std::uint64_t count, std::size_t element_size) const
+{
+   if (count > remaining() / element_size) {
+      throw std::runtime_error("compiled configuration is truncated");
+   }
+}
+
+void CompiledConfigReader::copy(void* to, std::size_t size)
+{
+   check(size, 1);
+   if (size != 0) {
+      std::memcpy(to, data_.data() + position_, size);
+   }
+   position_ += size;
+}
+
+void CompiledConfigReader::align()
+{
+   const auto aligned = (position_ + table_alignment - 1) / table_alignment * table_alignment;
+   check(aligned - position_, 1);
+   position_ = aligned;
+}
+
+bool ConfigParser::save_compiled(std::string const& file_name, std::vector<std::string> const& sources) const
+{
+   // regexes can only be stored as text, entries given as compiled std::regex cannot be saved
+   if (!path_templates_ || delete_lines_regex_patterns_.size() != delete_lines_regex_.size()) {
+      return false;
+   }
+
+   CompiledConfigWriter out;
+   out.put_strings(sources);
+   out.put_strings(disabled_categories_);
+   out.put_value(static_cast<std::uint64_t>(translations_.size()));
+   for (auto const& tr : translations_) {
+      out.put_string(tr.category);
+      out.put_strings(tr.patterns);
+      out.put_string(tr.print);
+      out.put_value(static_cast<std::uint64_t>(tr.variables.size()));
+      for (auto const& var : tr.variables) {
+         out.put_string(var.startswith);
+         out.put_string(var.endswith);
+      }
+      out.put_value(tr.duplicates);
+      out.put_value(static_cast<std::uint64_t>(tr.print_format.size()));
+      for (auto const& segment : tr.print_format) {
+         out.put_string(segment.text);
+         out.put_value(static_cast<std::uint64_t>(segment.variable));
+      }
+   }
+   translation_matcher_.write(out);
+   out.put_value(static_cast<std::uint64_t>(pairs_.size()));
+   for (auto const& pr : pairs_) {
+      out.put_string(pr.source);
+      out.put_string(pr.pairswith);
+      out.put_string(pr.before);
+      out.put_string(pr.error);
+   }
+   pair_matcher_.write(out);
+   out.put_strings(path_templates_->wrap_text_pre);
+   out.put_strings(path_templates_->wrap_text_post);
+   out.put_strings(path_templates_->execute_commands);
+   out.put_string(path_templates_->translation_file);
+   out.put_string(path_templates_->backup_file);
+   out.put_strings(delete_lines_);
+   out.put_value(static_cast<std::uint64_t>(delete_lines_linear_.size()));
+   for (auto const& linear : delete_lines_linear_) {
+      linear.write(out);
+   }
+   out.put_strings(delete_lines_regex_patterns_);
+   out.put_strings(blacklists_);
+   line_filter_.write(out);
+   out.put_value(static_cast<std::uint64_t>(replace_words_.size()));
+   for (auto const& replace : replace_words_) {
+      out.put_string(replace.search);
+      out.put_string(replace.replace);
+   }
+   out.put_value(auto_new_line_);
+
+   header head;
+   std::copy(magic.begin(), magic.end(), head.tag.begin());
+   head.version = format_version;
+   head.layout = layout();
+   head.size = out.data().size();
+   head.checksum = checksum(out.data());
+
+   // replace the previous file only once the new one is complete
+   const std::string temp_file_name = file_name + ".tmp";
+   {
+      std::ofstream file(temp_file_name, std::ios::binary | std::ios::trunc);
+      file.write(reinterpret_cast<char const*>(&head), sizeof(head));
+      file.write(out.data().data(), static_cast<std::streamsize>(out.data().size()));
+      if (!file.flush()) {
+         return false;
+      }
+   }
+   std::error_code error;
+   fs::rename(temp_file_name, file_name, error);
+   return !error;
+}
+
+bool ConfigParser::load_compiled(std::string const& file_name)
+{
+   std::ifstream file(file_name, std::ios::binary | std::ios::ate);
+   if (!file) {
+      return false;
+   }
+   const auto size = static_cast<std::size_t>(file.tellg());
+   header head;
+   if (size < sizeof(head)) {
+      return false;
+   }
+   std::string data(size, '\0');
+   file.seekg(0);
+   if (!file.read(data.data(), static_cast<std::streamsize>(size))) {
+      return false;
+   }
+   std::memcpy(&head, data.data(), sizeof(head));
+   const std::string_view body = std::string_view(data).substr(sizeof(head));
+   if (std::string_view(head.tag.data(), head.tag.size()) != magic || head.version != format_version ||
+       head.layout != layout() || head.size != body.size() || head.checksum != checksum(body)) {
+      return false;
+   }
+
+   try {
+      CompiledConfigReader in(body);
+      if (!newer_than_sources(file_name, in.get_strings())) {
+         return false;
+      }
+      auto disabled_categories = in.get_strings();
+      std::vector<translation> translations(static_cast<std::size_t>(in.get_value<std::uint64_t>()));
+      for (auto& tr : translations) {
+         tr.category = in.get_string();
+         tr.patterns = in.get_strings();
+         tr.print = in.get_string();
+         tr.variables.resize(static_cast<std::size_t>(in.get_value<std::uint64_t>()));
+         for (auto& var : tr.variables) {
+            var.startswith = in.get_string();
+            var.endswith = in.get_string();
+         }
+         tr.duplicates = in.get_value<duplicates_t>();
+         tr.print_format.resize(static_cast<std::size_t>(in.get_value<std::uint64_t>()));
+         for (auto& segment : tr.print_format) {
+            segment.text = in.get_string();
+            segment.variable = static_cast<std::size_t>(in.get_value<std::uint64_t>());
+         }
+         tr.compile_search();
+      }
+      auto translation_matcher = TranslationMatcher::read(in);
+      std::vector<pair> pairs(static_cast<std::size_t>(in.get_value<std::uint64_t>()));
+      for (auto& pr : pairs) {
+         pr.source = in.get_string();
+         pr.pairswith = in.get_string();
+         pr.before = in.get_string();
+         pr.error = in.get_string();
+      }
+      auto pair_matcher = PairMatcher::read(in);
+      path_templates templates;
+      templates.wrap_text_pre = in.get_strings();
+      templates.wrap_text_post = in.get_strings();
+      templates.execute_commands = in.get_strings();
+      templates.translation_file = in.get_string();
+      templates.backup_file = in.get_string();
+      auto delete_lines = in.get_strings();
+      std::vector<LinearRegex> delete_lines_linear;
+      for (auto count = in.get_value<std::uint64_t>(); count != 0; --count) {
+         delete_lines_linear.push_back(LinearRegex::read(in));
+      }
+      auto delete_lines_regex_patterns = in.get_strings();
+      auto blacklists = in.get_strings();
+      auto line_filter = LineFilter::read(in);
+      std::vector<replacement> replace_words;
+      for (auto count = in.get_value<std::uint64_t>(); count != 0; --count) {
+         auto search = in.get_string();
+         replace_words.emplace_back(std::move(search), in.get_string());
+      }
+      const auto auto_new_line = in.get_value<bool>();
+      if (!in.at_end()) {
+         return false;
+      }
+
+      // the regexes are the only part that has to be compiled again
+      set_delete_lines_regex_patterns(std::move(delete_lines_regex_patterns));
+      disabled_categories_ = std::move(disabled_categories);
+      translations_ = std::move(translations);
+      translation_matcher_ = std::move(translation_matcher);
+      pairs_ = std::move(pairs);
+      pair_matcher_ = std::move(pair_matcher);
+      delete_lines_ = std::move(delete_lines);
+      delete_lines_linear_ = std::move(delete_lines_linear);
+      blacklists_ = std::move(blacklists);
+      line_filter_ = std::move(line_filter);
+      replace_words_ = std::move(replace_words);
+      auto_new_line_ = auto_new_line;
+      path_templates_ = std::move(templates);
+   }
+   catch (std::exception const&) {
+      return false;
+   }
+   // expands the path variables into the templates
+   set_path_variables(input_file_details_);
+   return true;
+}
+
+}  // namespace Logalizer::Config
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace Logalizer::Config {
+
+/**
+ * @brief CompiledConfigWriter lays out a loaded configuration as one flat block of bytes
+ *
+ * Numbers and tables are stored as they are in memory and every table starts at a multiple of 8 bytes,
+ * so reading them back is a copy without any parsing. The layout depends on the build, the header
+ * written by ConfigParser::save_compiled records what it depends on.
+ */
+class CompiledConfigWriter {
+  public:
+   template <class T>
+   requires std::is_trivially_copyable_v<T>
+   void put_value(T value)
+   {
+      append(&value, sizeof(value));
+   }
+
+   template <class T>
+   requires std::is_trivially_copyable_v<T>
+   void put_vector(std::vector<T> const& values)
+   {
+      put_value(static_cast<std::uint64_t>(values.size()));
+      align();
+      append(values.data(), values.size() * sizeof(T));
+   }
+
+   template <class T, std::size_t N>
+   requires std::is_trivially_copyable_v<T>
+   void put_array(std::array<T, N> const& values)
+   {
+      align();
+      append(values.data(), sizeof(values));
+   }
+
+   void put_string(std::string_view text);
+   void put_strings(std::vector<std::string> const& texts);
+
+   [[nodiscard]] std::string const& data() const noexcept
+   {
+      return data_;
+   }
+
+  private:
+   void append(void const* data, std::size_t size);
+   void align();
+
+   std::string data_;
+};
+
+/**
+ * @brief CompiledConfigReader reads the values of a CompiledConfigWriter in the order they were written
+ *
+ * Every getter throws std::runtime_error instead of reading past the end of the data.
+ */
+class CompiledConfigReader {
+  public:
+   explicit CompiledConfigReader(std::string_view data) : data_(data)
+   {
+   }
+
+   template <class T>
+   requires std::is_trivially_copyable_v<T>
+   [[nodiscard]] T get_value()
+   {
+      T value;
+      copy(&value, sizeof(value));
+      return value;
+   }
+
+   template <class T>
+   requires std::is_trivially_copyable_v<T>
+   [[nodiscard]] std::vector<T> get_vector()
+   {
+      const auto size = get_value<std::uint64_t>();
+      align();
+      // a damaged size must not allocate more than the rest of the data
+      check(size, sizeof(T));
+      std::vector<T> values(static_cast<std::size_t>(size));
+      copy(values.data(), values.size() * sizeof(T));
+      return values;
+   }
+
+   template <class T, std::size_t N>
+   requires std::is_trivially_copyable_v<T>
+   void get_array(std::array<T, N>* values)
+   {
+      align();
+      copy(values->data(), sizeof(*values));
+   }
+
+   [[nodiscard]] std::string get_string();
+   [[nodiscard]] std::vector<std::string> get_strings();
+
+   [[nodiscard]] bool at_end() const noexcept
+   {
+      return position_ == data_.size();
+   }
+
+  private:
+   [[nodiscard]] std::size_t remaining() const noexcept
+   {
+      return data_.size() - position_;
+   }
+   void check(std::uint64_t count, std::size_t element_size) const;
+   void copy(void* to, std::size_t size);
+   void align();
+
+   std::string_view data_;
+   std::size_t position_ = 0;
+};
+
+}  // namespace Logalizer::Config
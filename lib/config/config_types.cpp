@@ -0,0 +1,90 @@
+#include "config_types.h"
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+
+namespace Logalizer::Config {
+
+void translation::compile_print()
+{
+   print_format.clear();
+   auto add_text = [this](std::string_view text) {
+      if (text.empty()) {
+         return;
+      }
+      if (!print_format.empty() && print_format.back().variable == print_segment::no_variable) {
+         print_format.back().text += text;
+      }
+      else {
+         print_format.push_back({std::string(text)});
+      }
+   };
+   auto add_variable = [this](std::size_t index) { print_format.push_back({std::string{}, index}); };
+
+   if (variables.empty()) {
+      add_text(print);
+      return;
+   }
+
+   if (print.find("${1}") == std::string::npos) {
+      add_text(print);
+      add_text("(");
+      for (std::size_t index = 0; index < variables.size(); ++index) {
+         if (index != 0) {
+            add_text(", ");
+         }
+         add_variable(index);
+      }
+      add_text(")");
+      return;
+   }
+
+   std::string_view rest = print;
+   while (!rest.empty()) {
+      const auto open = rest.find("${");
+      if (open == std::string_view::npos) {
+         add_text(rest);
+         break;
+      }
+      add_text(rest.substr(0, open));
+      rest.remove_prefix(open);
+
+      // ${N} with N written without leading zeros, anything else is text
+      const auto close = rest.find('}');
+      const auto digits = rest.substr(2, (close == std::string_view::npos) ? 0 : close - 2);
+      std::size_t number = 0;
+      const auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), number);
+      if (!digits.empty() && digits.front() != '0' && error == std::errc{} && end == digits.data() + digits.size() &&
+          number <= variables.size()) {
+         add_variable(number - 1);
+         rest.remove_prefix(close + 1);
+      }
+      else {
+         add_text(rest.substr(0, 2));
+         rest.remove_prefix(2);
+      }
+   }
+}
+
+void translation::compile_search()
+{
+   pattern_searches.clear();
+   for (auto const& pattern : patterns) {
+      pattern_searches.emplace_back(pattern);
+   }
+   variable_searches.clear();
+   for (auto const& var : variables) {
+      variable_searches.push_back({LiteralSearch(var.startswith), LiteralSearch(var.endswith)});
+   }
+}
+
+bool translation::in(std::string_view line) const
+{
+   assert(std::equal(cbegin(patterns), cend(patterns), cbegin(pattern_searches), cend(pattern_searches),
+                     [](auto const& pattern, auto const& search) { return pattern == search.needle(); }) &&
+          "compile_search was not run after the patterns changed");
+   return std::all_of(cbegin(pattern_searches), cend(pattern_searches),
+                      [&line](auto const& pattern) { return pattern.in(line); });
+}
+
+}  // namespace Logalizer::Config
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <algorithm>
+#include <regex>
 #include <string>
+#include <string_view>
 #include <vector>
+#include "literal_search.h"
 
 namespace Logalizer::Config {
 
@@ -22,6 +25,15 @@ struct variable {
    std::string endswith;
 };
 
+/**
+ * @brief The start and end strings of a variable, compiled for searching
+ *
+ */
+struct variable_search {
+   LiteralSearch startswith;
+   LiteralSearch endswith;
+};
+
 /**
  * @brief Defines how to handle duplicates in translation
  *
@@ -50,6 +62,17 @@ struct pair {
    std::string error;      /// If a matching pair is not found print this error_print before the terminator
 };
 
+/**
+ * @brief A piece of a compiled print
+ *
+ * Either literal text or a placeholder for the captured value of a variable.
+ */
+struct print_segment {
+   static constexpr std::size_t no_variable = static_cast<std::size_t>(-1);
+   std::string text;                    /// literal text, empty for a variable
+   std::size_t variable = no_variable;  /// index into translation::variables, no_variable for literal text
+};
+
 /**
  * @brief translation holds all the configuration needed to translate a line
  *
@@ -63,26 +86,62 @@ struct translation {
    std::vector<variable> variables;
    duplicates_t duplicates = duplicates_t::allowed;
    int padding_variable;
+   std::vector<print_segment> print_format;  /// print split into text and variables by compile_print
+   std::vector<LiteralSearch> pattern_searches;     /// patterns compiled by compile_search
+   std::vector<variable_search> variable_searches;  /// variables compiled by compile_search
 
-   [[nodiscard]] bool in(std::string const& line) const
-   {
-      auto matches = [&line](auto const& pattern) {
-         return static_cast<bool>(line.find(pattern) != std::string::npos);
-      };
-      return std::all_of(cbegin(patterns), cend(patterns), matches);
-   }
+   /**
+    * @brief Compile print into print_format
+    *
+    * Without variables the print is used as is.
+    * If the print contains ${1}, every ${N} of an existing variable N is replaced by its value.
+    * Otherwise the values are appended to the print as (value1, value2, ...).
+    */
+   void compile_print();
+
+   /**
+    * @brief Compile patterns and variables into pattern_searches and variable_searches
+    *
+    */
+   void compile_search();
+
+   /**
+    * @brief Check if line contains all patterns
+    *
+    * compile_search has to be run after patterns are changed.
+    */
+   [[nodiscard]] bool in(std::string_view line) const;
 };
 
 /**
  * @brief Holds search and replace tokens
  *
  * This will be used to search a token and replace it in the input line
+ * The search regex is compiled once on construction. Searches without regex syntax are marked literal
+ * and can be replaced with a plain string search. Throws std::regex_error for an invalid search.
  */
 struct replacement {
    std::string search;
    std::string replace;
-   replacement(std::string s, std::string r) : search(std::move(s)), replace(std::move(r))
+   std::regex search_regex;       /// compiled search, not used for literal replacements
+   LiteralSearch search_literal;  /// compiled search of literal replacements
+   bool literal = false;          /// replacing every occurrence of search gives the same result as the regex
+   replacement(std::string s, std::string r)
+       : search(std::move(s)), replace(std::move(r)), literal(is_literal(search, replace))
+   {
+      if (literal) {
+         search_literal = LiteralSearch(search);
+      }
+      else {
+         search_regex = std::regex(search, std::regex_constants::ECMAScript | std::regex_constants::optimize);
+      }
+   }
+
+   [[nodiscard]] static bool is_literal(std::string const& search, std::string const& replace)
    {
+      // '$' in the replacement refers to matched text in regex_replace
+      return !search.empty() && search.find_first_of("^$\\.*+?()[]{}|") == std::string::npos &&
+             replace.find('$') == std::string::npos;
    }
 };
 
@@ -2,6 +2,7 @@
 #include <iostream>
 #include <regex>
 #include <string>
+#include <utility>
 #include "path_variable_utils.h"
 
 namespace Logalizer::Config {
@@ -22,6 +23,36 @@ void ConfigParser::update_path_variables()
    std::for_each(begin(wrap_text_post_), end(wrap_text_post_), [&](auto &entry) { update_path_vars(&entry); });
 }
 
+void ConfigParser::set_path_variables(path_vars input_file_details)
+{
+   input_file_details_ = std::move(input_file_details);
+   if (!path_templates_) {
+      return;
+   }
+   execute_commands_ = path_templates_->execute_commands;
+   translation_file_ = path_templates_->translation_file;
+   backup_file_ = path_templates_->backup_file;
+   wrap_text_pre_ = path_templates_->wrap_text_pre;
+   wrap_text_post_ = path_templates_->wrap_text_post;
+   try {
+      update_path_variables();
+   }
+   catch (std::exception &e) {
+      std::cerr << "[warn] Special variables for path not updated " << e.what() << "\n";
+   }
+}
+
+void ConfigParser::set_delete_lines_regex_patterns(std::vector<std::string> patterns)
+{
+   std::vector<std::regex> delete_lines_regex;
+   for (auto const &pattern : patterns) {
+      delete_lines_regex.emplace_back(
+          pattern, std::regex_constants::grep | std::regex_constants::nosubs | std::regex_constants::optimize);
+   }
+   delete_lines_regex_ = std::move(delete_lines_regex);
+   delete_lines_regex_patterns_ = std::move(patterns);
+}
+
 bool ConfigParser::is_disabled(const std::string &category)
 {
    return std::any_of(cbegin(disabled_categories_), cend(disabled_categories_),
@@ -105,6 +136,8 @@ void ConfigParser::load_configurations()
    catch (...) {
       auto_new_line_ = true;
    }
+   path_templates_ =
+       path_templates{execute_commands_, translation_file_, backup_file_, wrap_text_pre_, wrap_text_post_};
    try {
       update_path_variables();
    }
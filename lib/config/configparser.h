@@ -1,8 +1,13 @@
 #pragma once
 
+#include <optional>
 #include <regex>
 #include <utility>
 #include "config_types.h"
+#include "line_filter.h"
+#include "linear_regex.h"
+#include "pair_matcher.h"
+#include "translation_matcher.h"
 
 namespace Logalizer::Config {
 
@@ -60,21 +65,63 @@ class ConfigParser {
    virtual bool is_disabled(const std::string& category) final;
    virtual duplicates_t get_duplicate_type(std::string const& dup) final;
 
-   void set_path_variables(path_vars input_file_details)
-   {
-      input_file_details_ = std::move(input_file_details);
-   }
+   /**
+    * @brief Set the paths that replace ${fileDirname}, ${fileBasename} and ${fileBasenameNoExtension}
+    *
+    * Before load_configurations the paths are used when loading. Afterwards the loaded commands, files and
+    * wrap texts are expanded again from their configured text, so one loaded configuration can be reused
+    * for several logs without reading it again.
+    *
+    * @param input_file_details
+    */
+   void set_path_variables(path_vars input_file_details);
+
+   /**
+    * @brief Write the loaded configuration and its compiled matchers to file_name
+    *
+    * The path variables are stored unexpanded, so the file serves every log. Loading it with
+    * load_compiled skips reading the sources and building the matchers.
+    *
+    * @param file_name
+    * @param sources files the configuration was read from, the compiled file is out of date once one of them
+    * is modified
+    * @return false if the configuration is not loaded or the file could not be written
+    */
+   [[nodiscard]] bool save_compiled(std::string const& file_name, std::vector<std::string> const& sources) const;
+
+   /**
+    * @brief Load a configuration written by save_compiled instead of loading it from its sources
+    *
+    * The path variables set with set_path_variables are expanded as with load_configurations.
+    * The file is read into memory and its fields and tables are copied into the configuration one by
+    * one. No JSON or CSV is parsed, but the file is not mapped and used in place.
+    *
+    * @param file_name
+    * @return false if the file is missing, damaged, written by another build or older than one of its
+    * sources. Nothing is loaded then.
+    */
+   [[nodiscard]] bool load_compiled(std::string const& file_name);
 
    [[nodiscard]] inline std::vector<translation> const& get_translations() const noexcept
    {
       return translations_;
    }
 
+   [[nodiscard]] inline TranslationMatcher const& get_translation_matcher() const noexcept
+   {
+      return translation_matcher_;
+   }
+
    [[nodiscard]] inline std::vector<pair> const& get_pairs() const noexcept
    {
       return pairs_;
    }
 
+   [[nodiscard]] inline PairMatcher const& get_pair_matcher() const noexcept
+   {
+      return pair_matcher_;
+   }
+
    [[nodiscard]] inline std::vector<std::string> const& get_disabled_categories() const noexcept
    {
       return disabled_categories_;
@@ -94,10 +141,18 @@ class ConfigParser {
    {
       return delete_lines_regex_;
    }
+   [[nodiscard]] inline std::vector<LinearRegex> const& get_delete_lines_linear() const noexcept
+   {
+      return delete_lines_linear_;
+   }
    [[nodiscard]] inline std::vector<std::string> const& get_delete_lines() const noexcept
    {
       return delete_lines_;
    }
+   [[nodiscard]] inline LineFilter const& get_line_filter() const noexcept
+   {
+      return line_filter_;
+   }
    [[nodiscard]] inline std::vector<replacement> const& get_replace_words() const noexcept
    {
       return replace_words_;
@@ -129,11 +184,17 @@ class ConfigParser {
    void set_translations(std::vector<translation> translations)
    {
       translations_ = std::move(translations);
+      std::for_each(begin(translations_), end(translations_), [](auto& tr) {
+         tr.compile_print();
+         tr.compile_search();
+      });
+      translation_matcher_ = TranslationMatcher(translations_);
    }
 
    void set_pairs(std::vector<pair> pairs)
    {
       pairs_ = std::move(pairs);
+      pair_matcher_ = PairMatcher(pairs_);
    }
 
    void set_disabled_categories(std::vector<std::string> disabled_categories)
@@ -156,9 +217,22 @@ class ConfigParser {
       delete_lines_regex_ = std::move(delete_lines_regex);
    }
 
+   /**
+    * @brief Compile delete_lines entries that need std::regex, keeping their text for save_compiled
+    *
+    * @param patterns grep syntax
+    */
+   void set_delete_lines_regex_patterns(std::vector<std::string> patterns);
+
+   void set_delete_lines_linear(std::vector<LinearRegex> delete_lines_linear)
+   {
+      delete_lines_linear_ = std::move(delete_lines_linear);
+   }
+
    void set_delete_lines(std::vector<std::string> delete_lines)
    {
       delete_lines_ = std::move(delete_lines);
+      line_filter_ = LineFilter(delete_lines_, blacklists_);
    }
 
    void set_replace_words(std::vector<replacement> replace_words)
@@ -169,6 +243,7 @@ class ConfigParser {
    void set_blacklists(std::vector<std::string> blacklists)
    {
       blacklists_ = std::move(blacklists);
+      line_filter_ = LineFilter(delete_lines_, blacklists_);
    }
 
    void set_execute_commands(std::vector<std::string> execute_commands)
@@ -211,18 +286,36 @@ class ConfigParser {
    virtual void load_pairs() = 0;
 
    std::vector<translation> translations_;
+   TranslationMatcher translation_matcher_;
    std::vector<pair> pairs_;
+   PairMatcher pair_matcher_;
    std::vector<std::string> disabled_categories_;
    std::vector<std::string> wrap_text_pre_;
    std::vector<std::string> wrap_text_post_;
-   std::vector<std::regex> delete_lines_regex_;
+   std::vector<std::regex> delete_lines_regex_;  /// delete regexes LinearRegex does not support
+   std::vector<std::string> delete_lines_regex_patterns_;  /// text of delete_lines_regex_, for save_compiled
+   std::vector<LinearRegex> delete_lines_linear_;
    std::vector<std::string> delete_lines_;
    std::vector<replacement> replace_words_;
    std::vector<std::string> blacklists_;
+   LineFilter line_filter_;
    std::vector<std::string> execute_commands_;
    std::string translation_file_;
    std::string backup_file_;
    bool auto_new_line_ = true;
    path_vars input_file_details_;
+
+   /**
+    * @brief Configured text of the settings that contain path variables, before they are expanded
+    *
+    */
+   struct path_templates {
+      std::vector<std::string> execute_commands;
+      std::string translation_file;
+      std::string backup_file;
+      std::vector<std::string> wrap_text_pre;
+      std::vector<std::string> wrap_text_post;
+   };
+   std::optional<path_templates> path_templates_;  /// set by load_configurations
 };
 }  // namespace Logalizer::Config
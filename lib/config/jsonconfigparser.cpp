@@ -85,6 +85,7 @@ std::vector<translation> JsonConfigParser::load_translations_csv(std::string con
    std::vector<translation> translations;
    std::filesystem::path p(config_file_);
    std::string csv_file = (p.parent_path() / std::filesystem::path(translations_csv_file)).string();
+   translations_csv_file_ = csv_file;
 
    const short no_of_columns = 13;
    io::CSVReader<no_of_columns, io::trim_chars<' '>, io::double_quote_escape<',', '\"'>> in(csv_file);
@@ -160,6 +161,17 @@ void JsonConfigParser::read_config_file()
    std::cout << "configuration loaded from " << config_file_ << '\n';
 }
 
+std::vector<std::string> JsonConfigParser::get_source_files() const
+{
+   std::vector<std::string> sources;
+   for (auto const* file : {&config_file_, &translations_csv_file_}) {
+      if (!file->empty()) {
+         sources.push_back(std::filesystem::absolute(*file).string());
+      }
+   }
+   return sources;
+}
+
 void JsonConfigParser::load_disabled_categories()
 {
    set_disabled_categories(config_.at(TAG_DISABLE_CATEGORY).get<std::vector<std::string>>());
@@ -238,26 +250,29 @@ void JsonConfigParser::load_delete_lines()
 {
    auto deletors = config_.at(TAG_DELETE_LINES).get<std::vector<std::string>>();
 
-   std::vector<std::regex> delete_lines_regex;
+   std::vector<LinearRegex> delete_lines_linear;
    std::vector<std::string> delete_lines;
+   std::vector<std::string> slow_entries;
    for (auto const& entry : deletors) {
-      if (entry.find_first_of("[\\^$.|?*+") != std::string::npos) {
-         delete_lines_regex.emplace_back(
-             entry, std::regex_constants::grep | std::regex_constants::nosubs | std::regex_constants::optimize);
+      if (entry.find_first_of("[\\^$.|?*+") == std::string::npos) {
+         delete_lines.emplace_back(entry);
+      }
+      else if (auto linear = LinearRegex::compile(entry)) {
+         delete_lines_linear.push_back(*linear);
       }
       else {
-         delete_lines.emplace_back(entry);
+         slow_entries.push_back(entry);
       }
    }
-   set_delete_lines_regex(delete_lines_regex);
+   set_delete_lines_regex_patterns(slow_entries);
+   set_delete_lines_linear(delete_lines_linear);
    set_delete_lines(delete_lines);
 
-   if (!delete_lines_regex.empty()) {
-      std::cerr << "[warn] Use of regex in " << TAG_DELETE_LINES << " is a lot slower. Use normal search instead,\n";
-      for (auto const& entry : deletors) {
-         if (entry.find_first_of("[\\^$.|?*+") != std::string::npos) {
-            std::cout << "  " << entry << '\n';
-         }
+   if (!slow_entries.empty()) {
+      std::cerr << "[warn] These regex in " << TAG_DELETE_LINES
+                << " need std::regex, which is a lot slower. Use simpler regex or normal search instead,\n";
+      for (auto const& entry : slow_entries) {
+         std::cout << "  " << entry << '\n';
       }
    }
 }
@@ -267,7 +282,13 @@ void JsonConfigParser::load_replace_words()
    const json j_tr = config_.at(TAG_REPLACE_WORDS);
    std::vector<replacement> replace_words;
    for (const auto& [key, value] : j_tr.items()) {
-      replace_words.emplace_back(key, value);
+      try {
+         replace_words.emplace_back(key, value);
+      }
+      catch (std::regex_error const& e) {
+         std::cerr << "[warn] " << TAG_REPLACE_WORDS << " entry ignored, invalid regex " << key << " : " << e.what()
+                   << "\n";
+      }
    }
    set_replace_words(replace_words);
 }
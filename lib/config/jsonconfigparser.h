@@ -28,9 +28,17 @@ class JsonConfigParser final : public ConfigParser {
 
    void read_config_file() override;
 
+   /**
+    * @brief Get the files the configuration was read from, see ConfigParser::save_compiled
+    *
+    * @return the configuration file and its translations_csv file, if any
+    */
+   [[nodiscard]] std::vector<std::string> get_source_files() const;
+
   private:
    json config_;
    std::string config_file_;
+   std::string translations_csv_file_;  /// path of the translations_csv file once loaded
    template <class T>
    T get_value_or(json const& config, std::string const& name, T value);
    std::vector<variable> get_variables(json const& config);
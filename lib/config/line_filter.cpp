@@ -0,0 +1,63 @@
+#include "line_filter.h"
+#include <algorithm>
+#include <cstdint>
+#include "compiled_config.h"
+
+namespace Logalizer::Config {
+
+LineFilter::LineFilter(std::vector<std::string> const& delete_lines, std::vector<std::string> const& blacklists)
+{
+   std::vector<std::string> patterns;
+   patterns.reserve(delete_lines.size() + blacklists.size());
+   auto add = [&](std::vector<std::string> const& entries, unsigned list) {
+      for (auto const& entry : entries) {
+         if (entry.empty()) {
+            always_ |= list;
+            continue;
+         }
+         // an entry of both lists is reported once, with the id of its first occurrence
+         const auto first = std::find(begin(patterns), end(patterns), entry);
+         if (first == end(patterns)) {
+            patterns.push_back(entry);
+            lists_.push_back(list);
+         }
+         else {
+            lists_[static_cast<std::size_t>(first - begin(patterns))] |= list;
+         }
+      }
+   };
+   add(delete_lines, deleted);
+   add(blacklists, blacklisted);
+   automaton_ = AhoCorasick(patterns);
+}
+
+unsigned LineFilter::find(std::string_view line, unsigned wanted) const
+{
+   unsigned found = always_ & wanted;
+   if (found == wanted) {
+      return found;
+   }
+   automaton_.scan(line, [&](std::uint32_t id) {
+      found |= lists_[id] & wanted;
+      return found != wanted;
+   });
+   return found;
+}
+
+void LineFilter::write(CompiledConfigWriter& out) const
+{
+   automaton_.write(out);
+   out.put_vector(lists_);
+   out.put_value(always_);
+}
+
+LineFilter LineFilter::read(CompiledConfigReader& in)
+{
+   LineFilter filter;
+   filter.automaton_ = AhoCorasick::read(in);
+   filter.lists_ = in.get_vector<unsigned>();
+   filter.always_ = in.get_value<unsigned>();
+   return filter;
+}
+
+}  // namespace Logalizer::Config
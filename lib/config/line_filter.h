@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "aho_corasick.h"
+
+namespace Logalizer::Config {
+
+class CompiledConfigReader;
+class CompiledConfigWriter;
+
+/**
+ * @brief LineFilter checks a line against the delete_lines and blacklist entries at once
+ *
+ * Both lists are compiled into one AhoCorasick automaton, so a line is classified for both of them
+ * in a single scan. An empty entry is contained in every line, as with std::string::find.
+ */
+class LineFilter {
+  public:
+   static constexpr unsigned deleted = 1;      /// a delete_lines entry is in the line
+   static constexpr unsigned blacklisted = 2;  /// a blacklist entry is in the line
+
+   LineFilter() = default;
+   LineFilter(std::vector<std::string> const& delete_lines, std::vector<std::string> const& blacklists);
+
+   /**
+    * @brief Find which lists have an entry in line
+    *
+    * The scan stops as soon as all the wanted lists are found.
+    *
+    * @param line
+    * @param wanted combination of deleted and blacklisted
+    * @return the wanted lists that have an entry in line
+    */
+   [[nodiscard]] unsigned find(std::string_view line, unsigned wanted) const;
+
+   /**
+    * @brief Store the compiled tables, see ConfigParser::save_compiled
+    *
+    * @param out
+    */
+   void write(CompiledConfigWriter& out) const;
+
+   /**
+    * @brief Restore the tables stored with write
+    *
+    * @param in
+    * @return LineFilter as it was written
+    */
+   [[nodiscard]] static LineFilter read(CompiledConfigReader& in);
+
+  private:
+   AhoCorasick automaton_;
+   std::vector<unsigned> lists_;  /// pattern -> lists the pattern is an entry of
+   unsigned always_ = 0;          /// lists with an empty entry
+};
+
+}  // namespace Logalizer::Config
@@ -0,0 +1,207 @@
+#include "linear_regex.h"
+#include <bitset>
+#include <vector>
+#include "compiled_config.h"
+
+namespace Logalizer::Config {
+
+namespace {
+
+using byte_set = std::bitset<256>;
+
+constexpr std::size_t max_elements = 63;  // one bit per element plus the accepting state
+
+bool is_ascii(char c)
+{
+   return static_cast<unsigned char>(c) < 0x80;
+}
+
+/**
+ * @brief Parse a bracket expression following '['
+ *
+ * Character classes, collating elements, backslashes and a '-' that is not first or last are not
+ * supported, their meaning differs between regex implementations.
+ *
+ * @return false if the expression is not supported
+ */
+bool parse_bracket(std::string_view pattern, std::size_t* at, byte_set* bytes)
+{
+   const bool negate = *at < pattern.size() && pattern[*at] == '^';
+   if (negate) {
+      ++*at;
+   }
+   for (bool first = true;; first = false) {
+      if (*at >= pattern.size()) {
+         return false;
+      }
+      const char low = pattern[(*at)++];
+      if (low == ']' && !first) {
+         break;
+      }
+      const bool last = *at < pattern.size() && pattern[*at] == ']';
+      if (low == '[' || low == '\\' || !is_ascii(low) || (low == '-' && !first && !last)) {
+         return false;
+      }
+      if (*at + 1 < pattern.size() && pattern[*at] == '-' && pattern[*at + 1] != ']') {
+         const char high = pattern[*at + 1];
+         *at += 2;
+         if (high == '[' || high == '\\' || high == '-' || low == '-' || !is_ascii(high) || high < low) {
+            return false;
+         }
+         for (int byte = low; byte <= high; ++byte) {
+            bytes->set(static_cast<std::size_t>(byte));
+         }
+      }
+      else {
+         bytes->set(static_cast<unsigned char>(low));
+      }
+   }
+   if (negate) {
+      bytes->flip();
+   }
+   return true;
+}
+
+}  // namespace
+
+std::optional<LinearRegex> LinearRegex::compile(std::string_view pattern)
+{
+   LinearRegex regex;
+   std::vector<int> literals;  // element -> its only byte, -1 if it matches more than one byte
+   std::size_t at = 0;
+   if (!pattern.empty() && pattern.front() == '^') {
+      regex.anchored_begin_ = true;
+      ++at;
+   }
+
+   while (at < pattern.size()) {
+      const char c = pattern[at++];
+      byte_set bytes;
+      switch (c) {
+         case '*':
+            // a leading '*' is rejected by std::regex
+            if (literals.empty()) {
+               return std::nullopt;
+            }
+            regex.star_ |= std::uint64_t{1} << (literals.size() - 1);
+            continue;
+         case '^':
+            return std::nullopt;
+         case '$':
+            if (at != pattern.size()) {
+               return std::nullopt;
+            }
+            regex.anchored_end_ = true;
+            continue;
+         case '.':
+            bytes.set();
+            bytes.reset(0);
+            break;
+         case '[':
+            if (!parse_bracket(pattern, &at, &bytes)) {
+               return std::nullopt;
+            }
+            break;
+         case '\\': {
+            if (at == pattern.size()) {
+               return std::nullopt;
+            }
+            const char escaped = pattern[at++];
+            if (std::string_view(".*[^$\\").find(escaped) == std::string_view::npos) {
+               return std::nullopt;
+            }
+            bytes.set(static_cast<unsigned char>(escaped));
+            break;
+         }
+         default:
+            bytes.set(static_cast<unsigned char>(c));
+            break;
+      }
+
+      if (literals.size() == max_elements) {
+         return std::nullopt;
+      }
+      const std::uint64_t element = std::uint64_t{1} << literals.size();
+      const bool single = bytes.count() == 1;
+      int literal = -1;
+      for (std::size_t byte = 0; byte < bytes.size(); ++byte) {
+         if (bytes.test(byte)) {
+            regex.byte_masks_[byte] |= element;
+            literal = single ? static_cast<int>(byte) : -1;
+         }
+      }
+      literals.push_back(literal);
+   }
+
+   regex.accept_ = std::uint64_t{1} << literals.size();
+   regex.start_ = regex.closure(1);
+
+   // elements that must match exactly one byte in a row are a substring of every match
+   std::string run;
+   for (std::size_t element = 0; element <= literals.size(); ++element) {
+      const bool literal = element < literals.size() && literals[element] >= 0 &&
+                           (regex.star_ & (std::uint64_t{1} << element)) == 0;
+      if (literal) {
+         run.push_back(static_cast<char>(literals[element]));
+         continue;
+      }
+      if (run.size() > regex.required_.size()) {
+         regex.required_ = run;
+      }
+      run.clear();
+   }
+   return regex;
+}
+
+bool LinearRegex::search(std::string_view line) const noexcept
+{
+   if (!required_.empty() && line.find(required_) == std::string_view::npos) {
+      return false;
+   }
+
+   std::uint64_t states = start_;
+   if ((states & accept_) != 0 && !anchored_end_) {
+      return true;
+   }
+   for (const char c : line) {
+      const std::uint64_t moved = states & byte_masks_[static_cast<unsigned char>(c)];
+      // a starred element stays in place, any other element advances to the next one
+      states = closure(((moved & ~star_) << 1U) | (moved & star_));
+      if (!anchored_begin_) {
+         states |= start_;
+      }
+      else if (states == 0) {
+         return false;
+      }
+      if ((states & accept_) != 0 && !anchored_end_) {
+         return true;
+      }
+   }
+   return (states & accept_) != 0;
+}
+
+void LinearRegex::write(CompiledConfigWriter& out) const
+{
+   out.put_array(byte_masks_);
+   out.put_value(star_);
+   out.put_value(start_);
+   out.put_value(accept_);
+   out.put_value(anchored_begin_);
+   out.put_value(anchored_end_);
+   out.put_string(required_);
+}
+
+LinearRegex LinearRegex::read(CompiledConfigReader& in)
+{
+   LinearRegex regex;
+   in.get_array(&regex.byte_masks_);
+   regex.star_ = in.get_value<std::uint64_t>();
+   regex.start_ = in.get_value<std::uint64_t>();
+   regex.accept_ = in.get_value<std::uint64_t>();
+   regex.anchored_begin_ = in.get_value<bool>();
+   regex.anchored_end_ = in.get_value<bool>();
+   regex.required_ = in.get_string();
+   return regex;
+}
+
+}  // namespace Logalizer::Config
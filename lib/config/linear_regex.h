@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace Logalizer::Config {
+
+class CompiledConfigReader;
+class CompiledConfigWriter;
+
+/**
+ * @brief LinearRegex searches a line for a basic (grep) regular expression in linear time
+ *
+ * The pattern is run as a bit parallel NFA, one bit per pattern element, so every byte of the line
+ * is looked at once and nothing is ever backtracked.
+ *
+ * Supported is the subset of grep syntax without alternation, groups and back references:
+ * literals, '.', bracket expressions with ranges, '*', a leading '^', a trailing '$' and the escapes
+ * \. \* \[ \^ \$ \\. Matches are the same as std::regex with std::regex_constants::grep.
+ * Other patterns are rejected by compile and have to be run with std::regex.
+ */
+class LinearRegex {
+  public:
+   /**
+    * @brief Compile pattern
+    *
+    * @param pattern grep syntax
+    * @return std::nullopt if pattern uses syntax that is not supported
+    */
+   [[nodiscard]] static std::optional<LinearRegex> compile(std::string_view pattern);
+
+   /**
+    * @brief Check if the pattern matches anywhere in line
+    *
+    * @param line
+    * @return true if a match is found
+    */
+   [[nodiscard]] bool search(std::string_view line) const noexcept;
+
+   /**
+    * @brief Store the compiled tables, see ConfigParser::save_compiled
+    *
+    * @param out
+    */
+   void write(CompiledConfigWriter& out) const;
+
+   /**
+    * @brief Restore the tables stored with write
+    *
+    * @param in
+    * @return LinearRegex as it was written
+    */
+   [[nodiscard]] static LinearRegex read(CompiledConfigReader& in);
+
+  private:
+   LinearRegex() = default;
+
+   [[nodiscard]] std::uint64_t closure(std::uint64_t states) const noexcept
+   {
+      // a starred element can be skipped, carries run through consecutive starred elements
+      return states | (((states & star_) + star_) ^ star_);
+   }
+
+   std::array<std::uint64_t, 256> byte_masks_{};  /// byte -> elements matching the byte
+   std::uint64_t star_ = 0;                       /// elements followed by '*'
+   std::uint64_t start_ = 0;                      /// states before anything is matched
+   std::uint64_t accept_ = 0;                     /// state after the last element
+   bool anchored_begin_ = false;
+   bool anchored_end_ = false;
+   std::string required_;  /// longest run of literal elements, every match contains it
+};
+
+}  // namespace Logalizer::Config
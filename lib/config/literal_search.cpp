@@ -0,0 +1,130 @@
+#include "literal_search.h"
+#include <bit>
+#include <cstring>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LOGALIZER_SSE2 1
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define LOGALIZER_AVX2_DISPATCH 1
+#endif
+
+namespace Logalizer::Config {
+
+namespace {
+std::size_t find_plain(std::string_view text, std::string_view needle, std::size_t /*second*/) noexcept
+{
+   return text.find(needle);
+}
+
+/**
+ * @brief Check the candidates in mask, bit n is the position at + n
+ *
+ */
+std::size_t first_candidate(std::string_view text, std::string_view needle, std::size_t at, unsigned mask) noexcept
+{
+   for (; mask != 0; mask &= mask - 1) {
+      const std::size_t candidate = at + static_cast<std::size_t>(std::countr_zero(mask));
+      if (std::memcmp(text.data() + candidate + 1, needle.data() + 1, needle.size() - 1) == 0) {
+         return candidate;
+      }
+   }
+   return std::string_view::npos;
+}
+
+/**
+ * @brief Search the positions after the last full block, those that a block compare would read past text
+ *
+ */
+std::size_t find_rest(std::string_view text, std::string_view needle, std::size_t at) noexcept
+{
+   const auto found = text.substr(at).find(needle);
+   return (found == std::string_view::npos) ? found : at + found;
+}
+
+#if defined(LOGALIZER_SSE2)
+std::size_t find_sse2(std::string_view text, std::string_view needle, std::size_t second) noexcept
+{
+   constexpr std::size_t block = 16;
+   const __m128i first_bytes = _mm_set1_epi8(needle.front());
+   const __m128i second_bytes = _mm_set1_epi8(needle[second]);
+   std::size_t at = 0;
+   for (; at + needle.size() + block - 1 <= text.size(); at += block) {
+      const __m128i firsts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + at));
+      const __m128i seconds = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + at + second));
+      const __m128i both = _mm_and_si128(_mm_cmpeq_epi8(firsts, first_bytes), _mm_cmpeq_epi8(seconds, second_bytes));
+      const auto mask = static_cast<unsigned>(_mm_movemask_epi8(both));
+      if (const auto found = first_candidate(text, needle, at, mask); found != std::string_view::npos) {
+         return found;
+      }
+   }
+   return find_rest(text, needle, at);
+}
+#endif
+
+#if defined(LOGALIZER_AVX2_DISPATCH)
+__attribute__((target("avx2"))) std::size_t find_avx2(std::string_view text, std::string_view needle,
+                                                      std::size_t second) noexcept
+{
+   constexpr std::size_t block = 32;
+   const __m256i first_bytes = _mm256_set1_epi8(needle.front());
+   const __m256i second_bytes = _mm256_set1_epi8(needle[second]);
+   std::size_t at = 0;
+   for (; at + needle.size() + block - 1 <= text.size(); at += block) {
+      const __m256i firsts = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text.data() + at));
+      const __m256i seconds = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text.data() + at + second));
+      const auto mask = static_cast<unsigned>(_mm256_movemask_epi8(
+          _mm256_and_si256(_mm256_cmpeq_epi8(firsts, first_bytes), _mm256_cmpeq_epi8(seconds, second_bytes))));
+      if (const auto found = first_candidate(text, needle, at, mask); found != std::string_view::npos) {
+         return found;
+      }
+   }
+   return find_rest(text, needle, at);
+}
+#endif
+
+LiteralSearch::kernel best_kernel() noexcept
+{
+#if defined(LOGALIZER_AVX2_DISPATCH)
+   if (__builtin_cpu_supports("avx2")) {
+      return find_avx2;
+   }
+#endif
+#if defined(LOGALIZER_SSE2)
+   return find_sse2;
+#else
+   return find_plain;
+#endif
+}
+}  // namespace
+
+LiteralSearch::LiteralSearch(std::string needle) : needle_(std::move(needle))
+{
+   if (needle_.size() < 2) {
+      // empty needles and single bytes are left to find and memchr
+      kernel_ = find_plain;
+      return;
+   }
+   // a second byte equal to the first would only confirm candidates the first one found
+   second_ = needle_.size() - 1;
+   while (second_ > 1 && needle_[second_] == needle_.front()) {
+      --second_;
+   }
+   static const kernel best = best_kernel();
+   kernel_ = best;
+}
+
+std::size_t LiteralSearch::find(std::string_view text, std::size_t from) const noexcept
+{
+   if (kernel_ == nullptr || from > text.size()) {
+      return text.find(needle_, from);
+   }
+   const auto found = kernel_(text.substr(from), needle_, second_);
+   return (found == std::string_view::npos) ? found : from + found;
+}
+
+}  // namespace Logalizer::Config
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace Logalizer::Config {
+
+/**
+ * @brief LiteralSearch finds one literal needle in texts, made for the short needles of a configuration
+ *
+ * Candidates are positions where the first byte of the needle and one later byte that differs from
+ * it are both found, compared for 16 or 32 positions at a time. Only candidates are compared in
+ * full, so a text is not stopped at every occurrence of the first byte like std::string_view::find.
+ *
+ * The block compare uses AVX2 when the processor has it, otherwise SSE2, and the plain search
+ * everywhere else. The choice is made when the needle is compiled.
+ */
+class LiteralSearch {
+  public:
+   LiteralSearch() = default;
+   explicit LiteralSearch(std::string needle);
+
+   /**
+    * @brief Find the first occurrence of the needle in text at or after from
+    *
+    * @return position of the occurrence, std::string_view::npos if there is none
+    */
+   [[nodiscard]] std::size_t find(std::string_view text, std::size_t from = 0) const noexcept;
+
+   [[nodiscard]] bool in(std::string_view text) const noexcept
+   {
+      return find(text) != std::string_view::npos;
+   }
+
+   [[nodiscard]] std::string const& needle() const noexcept
+   {
+      return needle_;
+   }
+
+   /// searches text for needle, with needle[0] and needle[second] as the bytes compared first
+   using kernel = std::size_t (*)(std::string_view text, std::string_view needle, std::size_t second) noexcept;
+
+  private:
+   std::string needle_;
+   std::size_t second_ = 0;  /// the later byte compared with the first one, differs from it if possible
+   kernel kernel_ = nullptr;
+};
+
+}  // namespace Logalizer::Config
@@ -0,0 +1,101 @@
+#include "pair_matcher.h"
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include "compiled_config.h"
+
+namespace Logalizer::Config {
+
+PairMatcher::PairMatcher(std::vector<pair> const& pairs) : pairs_(pairs.size()), always_(pairs.size(), 0)
+{
+   std::vector<std::string> strings;
+   std::vector<std::vector<std::uint32_t>> users;
+   std::unordered_map<std::string_view, std::uint32_t> ids;
+
+   auto add = [&](std::uint32_t index, std::string const& text, std::uint8_t role) {
+      if (text.empty()) {
+         always_[index] |= role;
+         return;
+      }
+      const auto [found, added] = ids.try_emplace(text, static_cast<std::uint32_t>(strings.size()));
+      if (added) {
+         strings.push_back(text);
+         users.emplace_back();
+      }
+      users[found->second].push_back(index << 3U | role);
+   };
+
+   for (std::uint32_t index = 0; index < pairs.size(); ++index) {
+      add(index, pairs[index].source, source);
+      add(index, pairs[index].pairswith, pairswith);
+      add(index, pairs[index].before, before);
+      if (always_[index] != 0) {
+         always_pairs_.push_back(index);
+      }
+   }
+
+   users_begin_.reserve(users.size() + 1);
+   for (auto const& user : users) {
+      users_begin_.push_back(static_cast<std::uint32_t>(users_.size()));
+      users_.insert(users_.end(), user.cbegin(), user.cend());
+   }
+   users_begin_.push_back(static_cast<std::uint32_t>(users_.size()));
+
+   automaton_ = AhoCorasick(strings);
+}
+
+void PairMatcher::find(std::string_view line, scratch& work) const
+{
+   if (work.roles.size() != pairs_) {
+      work.roles.assign(pairs_, 0);
+      work.found.clear();
+   }
+   for (const auto index : work.found) {
+      work.roles[index] = 0;
+   }
+   work.found.clear();
+
+   auto mark = [&work](std::uint32_t index, std::uint8_t role) {
+      if (work.roles[index] == 0) {
+         work.found.push_back(index);
+      }
+      work.roles[index] |= role;
+   };
+
+   for (const auto index : always_pairs_) {
+      mark(index, always_[index]);
+   }
+
+   automaton_.scan(line, [&](std::uint32_t id) {
+      for (auto user = users_begin_[id], end = users_begin_[id + 1]; user < end; ++user) {
+         mark(users_[user] >> 3U, static_cast<std::uint8_t>(users_[user] & 7U));
+      }
+      return true;
+   });
+
+   std::sort(work.found.begin(), work.found.end());
+}
+
+void PairMatcher::write(CompiledConfigWriter& out) const
+{
+   automaton_.write(out);
+   out.put_value(static_cast<std::uint64_t>(pairs_));
+   out.put_vector(always_);
+   out.put_vector(always_pairs_);
+   out.put_vector(users_begin_);
+   out.put_vector(users_);
+}
+
+PairMatcher PairMatcher::read(CompiledConfigReader& in)
+{
+   PairMatcher matcher;
+   matcher.automaton_ = AhoCorasick::read(in);
+   matcher.pairs_ = static_cast<std::size_t>(in.get_value<std::uint64_t>());
+   matcher.always_ = in.get_vector<std::uint8_t>();
+   matcher.always_pairs_ = in.get_vector<std::uint32_t>();
+   matcher.users_begin_ = in.get_vector<std::uint32_t>();
+   matcher.users_ = in.get_vector<std::uint32_t>();
+   return matcher;
+}
+
+}  // namespace Logalizer::Config
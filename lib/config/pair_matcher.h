@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "aho_corasick.h"
+#include "config_types.h"
+
+namespace Logalizer::Config {
+
+class CompiledConfigReader;
+class CompiledConfigWriter;
+
+/**
+ * @brief PairMatcher finds the source, pairswith and before strings of all pairs in one scan
+ *
+ * The strings of all pairs are compiled into one AhoCorasick automaton.
+ * Empty strings are found in every line, like std::string::find does.
+ */
+class PairMatcher {
+  public:
+   static constexpr std::uint8_t source = 1;
+   static constexpr std::uint8_t pairswith = 2;
+   static constexpr std::uint8_t before = 4;
+
+   /**
+    * @brief Result and working memory of find
+    *
+    */
+   struct scratch {
+      std::vector<std::uint8_t> roles;   /// per pair, which of its strings were found
+      std::vector<std::uint32_t> found;  /// pairs with at least one string found, in ascending order
+   };
+
+   PairMatcher() = default;
+   explicit PairMatcher(std::vector<pair> const& pairs);
+
+   /**
+    * @brief Find which strings of which pairs occur in line
+    *
+    * Clears the result of the previous call.
+    *
+    * @param line
+    * @param work receives the pairs found and their roles
+    */
+   void find(std::string_view line, scratch& work) const;
+
+   /**
+    * @brief Number of pairs
+    *
+    * @return std::size_t
+    */
+   [[nodiscard]] std::size_t size() const noexcept
+   {
+      return pairs_;
+   }
+
+   /**
+    * @brief Store the compiled tables, see ConfigParser::save_compiled
+    *
+    * @param out
+    */
+   void write(CompiledConfigWriter& out) const;
+
+   /**
+    * @brief Restore the tables stored with write
+    *
+    * @param in
+    * @return PairMatcher as it was written
+    */
+   [[nodiscard]] static PairMatcher read(CompiledConfigReader& in);
+
+  private:
+   AhoCorasick automaton_;
+   std::size_t pairs_ = 0;
+   std::vector<std::uint8_t> always_;        /// per pair, roles of its empty strings
+   std::vector<std::uint32_t> always_pairs_; /// pairs with at least one empty string
+   std::vector<std::uint32_t> users_begin_;  /// string -> first entry in users_
+   std::vector<std::uint32_t> users_;        /// pair index << 3 | role, for every pair using a string
+};
+
+}  // namespace Logalizer::Config
@@ -0,0 +1,115 @@
+#include "translation_matcher.h"
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include "compiled_config.h"
+
+namespace Logalizer::Config {
+
+TranslationMatcher::TranslationMatcher(std::vector<translation> const& translations)
+    : translations_(translations.size()), always_(translations.size()), required_(translations.size(), 0)
+{
+   std::vector<std::string> patterns;
+   std::vector<std::vector<std::uint32_t>> users;
+   std::unordered_map<std::string_view, std::uint32_t> ids;
+
+   for (std::uint32_t index = 0; index < translations.size(); ++index) {
+      for (auto const& pattern : translations[index].patterns) {
+         // an empty pattern is found in every line
+         if (pattern.empty()) {
+            continue;
+         }
+         const auto [found, added] = ids.try_emplace(pattern, static_cast<std::uint32_t>(patterns.size()));
+         if (added) {
+            patterns.push_back(pattern);
+            users.emplace_back();
+         }
+         auto& user = users[found->second];
+         if (user.empty() || user.back() != index) {
+            user.push_back(index);
+            ++required_[index];
+         }
+      }
+      if (required_[index] == 0 && always_ == translations_) {
+         always_ = index;
+      }
+   }
+
+   users_begin_.reserve(users.size() + 1);
+   for (auto const& user : users) {
+      users_begin_.push_back(static_cast<std::uint32_t>(users_.size()));
+      users_.insert(users_.end(), user.cbegin(), user.cend());
+   }
+   users_begin_.push_back(static_cast<std::uint32_t>(users_.size()));
+
+   automaton_ = AhoCorasick(patterns);
+}
+
+std::size_t TranslationMatcher::find(std::string_view line, scratch& work) const
+{
+   std::size_t best = always_;
+   if (best == 0 || automaton_.size() == 0) {
+      return best;
+   }
+
+   if (work.pattern_seen.size() != automaton_.size() || work.hits.size() != translations_) {
+      work.generation = 0;
+      work.pattern_seen.assign(automaton_.size(), 0);
+      work.translation_seen.assign(translations_, 0);
+      work.hits.assign(translations_, 0);
+   }
+   if (++work.generation == 0) {
+      std::ranges::fill(work.pattern_seen, 0);
+      std::ranges::fill(work.translation_seen, 0);
+      work.generation = 1;
+   }
+   const std::uint32_t generation = work.generation;
+
+   automaton_.scan(line, [&](std::uint32_t pattern) {
+      if (work.pattern_seen[pattern] == generation) {
+         return true;
+      }
+      work.pattern_seen[pattern] = generation;
+      for (auto user = users_begin_[pattern], end = users_begin_[pattern + 1]; user < end; ++user) {
+         const std::uint32_t index = users_[user];
+         // users are sorted, translations after the current best can not win anymore
+         if (index >= best) {
+            break;
+         }
+         if (work.translation_seen[index] != generation) {
+            work.translation_seen[index] = generation;
+            work.hits[index] = 0;
+         }
+         if (++work.hits[index] == required_[index]) {
+            best = index;
+         }
+      }
+      return best != 0;
+   });
+
+   return best;
+}
+
+void TranslationMatcher::write(CompiledConfigWriter& out) const
+{
+   automaton_.write(out);
+   out.put_value(static_cast<std::uint64_t>(translations_));
+   out.put_value(static_cast<std::uint64_t>(always_));
+   out.put_vector(required_);
+   out.put_vector(users_begin_);
+   out.put_vector(users_);
+}
+
+TranslationMatcher TranslationMatcher::read(CompiledConfigReader& in)
+{
+   TranslationMatcher matcher;
+   matcher.automaton_ = AhoCorasick::read(in);
+   matcher.translations_ = static_cast<std::size_t>(in.get_value<std::uint64_t>());
+   matcher.always_ = static_cast<std::size_t>(in.get_value<std::uint64_t>());
+   matcher.required_ = in.get_vector<std::uint32_t>();
+   matcher.users_begin_ = in.get_vector<std::uint32_t>();
+   matcher.users_ = in.get_vector<std::uint32_t>();
+   return matcher;
+}
+
+}  // namespace Logalizer::Config
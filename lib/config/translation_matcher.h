@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "aho_corasick.h"
+#include "config_types.h"
+
+namespace Logalizer::Config {
+
+class CompiledConfigReader;
+class CompiledConfigWriter;
+
+/**
+ * @brief TranslationMatcher finds the first translation whose patterns are all present in a line
+ *
+ * The patterns of all translations are compiled into one AhoCorasick automaton, so a line is scanned
+ * once no matter how many translations are configured.
+ * The result is the same as checking translation::in for every translation in configuration order.
+ */
+class TranslationMatcher {
+  public:
+   /**
+    * @brief Per caller working memory of find
+    *
+    * Reusing it across lines avoids clearing per translation state for every line.
+    */
+   struct scratch {
+      std::uint32_t generation = 0;
+      std::vector<std::uint32_t> pattern_seen;      /// generation in which a pattern was last found
+      std::vector<std::uint32_t> translation_seen;  /// generation in which hits of a translation were reset
+      std::vector<std::uint32_t> hits;              /// distinct patterns of a translation found in the line
+   };
+
+   TranslationMatcher() = default;
+   explicit TranslationMatcher(std::vector<translation> const& translations);
+
+   /**
+    * @brief Find the first matching translation
+    *
+    * @param line
+    * @param work working memory, may be shared across calls but not across threads
+    * @return index of the first matching translation or the number of translations if none matches
+    */
+   [[nodiscard]] std::size_t find(std::string_view line, scratch& work) const;
+
+   /**
+    * @brief Store the compiled tables, see ConfigParser::save_compiled
+    *
+    * @param out
+    */
+   void write(CompiledConfigWriter& out) const;
+
+   /**
+    * @brief Restore the tables stored with write
+    *
+    * @param in
+    * @return TranslationMatcher as it was written
+    */
+   [[nodiscard]] static TranslationMatcher read(CompiledConfigReader& in);
+
+  private:
+   AhoCorasick automaton_;
+   std::size_t translations_ = 0;
+   std::size_t always_ = 0;                  /// first translation without any non empty pattern
+   std::vector<std::uint32_t> required_;     /// distinct non empty patterns per translation
+   std::vector<std::uint32_t> users_begin_;  /// pattern -> first entry in users_
+   std::vector<std::uint32_t> users_;        /// translations using a pattern, in ascending order
+};
+
+}  // namespace Logalizer::Config
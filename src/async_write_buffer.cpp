@@ -0,0 +1,111 @@
+#include "async_write_buffer.h"
+
+AsyncWriteBuffer::AsyncWriteBuffer(std::streambuf* target, std::size_t buffer_size)
+    : target_(target), filling_(buffer_size), writing_(buffer_size)
+{
+   // tellp continues from where the target is, a resumed file is appended to
+   const auto position = target_->pubseekoff(0, std::ios_base::cur, std::ios_base::out);
+   if (position != pos_type(off_type(-1))) {
+      position_ = static_cast<std::uintmax_t>(off_type(position));
+   }
+   setp(filling_.data(), filling_.data() + filling_.size());
+   writer_ = std::thread([this]() { write(); });
+}
+
+AsyncWriteBuffer::~AsyncWriteBuffer()
+{
+   finish();
+}
+
+bool AsyncWriteBuffer::finish()
+{
+   if (finished_) {
+      return true;
+   }
+   finished_ = true;
+   const bool written = hand_over() && wait_written();
+   {
+      std::lock_guard lock(mutex_);
+      stop_ = true;
+   }
+   handed_.notify_one();
+   writer_.join();
+   setp(nullptr, nullptr);
+   return written && target_->pubsync() == 0;
+}
+
+AsyncWriteBuffer::int_type AsyncWriteBuffer::overflow(int_type ch)
+{
+   if (finished_ || !hand_over()) {
+      return traits_type::eof();
+   }
+   if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(ch);
+      pbump(1);
+   }
+   return traits_type::not_eof(ch);
+}
+
+int AsyncWriteBuffer::sync()
+{
+   if (finished_ || !hand_over() || !wait_written()) {
+      return -1;
+   }
+   return target_->pubsync();
+}
+
+AsyncWriteBuffer::pos_type AsyncWriteBuffer::seekoff(off_type off, std::ios_base::seekdir dir,
+                                                     std::ios_base::openmode which)
+{
+   if (off != 0 || dir != std::ios_base::cur || (which & std::ios_base::out) == 0) {
+      return pos_type(off_type(-1));
+   }
+   return pos_type(static_cast<off_type>(position_ + static_cast<std::uintmax_t>(pptr() - pbase())));
+}
+
+bool AsyncWriteBuffer::hand_over()
+{
+   const auto size = static_cast<std::size_t>(pptr() - pbase());
+   std::unique_lock lock(mutex_);
+   // the writer only touches writing_ while pending_ is set
+   written_.wait(lock, [this]() { return pending_ == 0; });
+   if (failed_) {
+      return false;
+   }
+   if (size == 0) {
+      return true;
+   }
+   filling_.swap(writing_);
+   pending_ = size;
+   lock.unlock();
+   handed_.notify_one();
+
+   position_ += size;
+   setp(filling_.data(), filling_.data() + filling_.size());
+   return true;
+}
+
+bool AsyncWriteBuffer::wait_written()
+{
+   std::unique_lock lock(mutex_);
+   written_.wait(lock, [this]() { return pending_ == 0; });
+   return !failed_;
+}
+
+void AsyncWriteBuffer::write()
+{
+   std::unique_lock lock(mutex_);
+   while (true) {
+      handed_.wait(lock, [this]() { return pending_ != 0 || stop_; });
+      if (pending_ == 0) {
+         return;
+      }
+      const auto size = static_cast<std::streamsize>(pending_);
+      lock.unlock();
+      const bool written = target_->sputn(writing_.data(), size) == size;
+      lock.lock();
+      failed_ = failed_ || !written;
+      pending_ = 0;
+      written_.notify_all();
+   }
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief AsyncWriteBuffer writes everything written to it into another stream buffer on a separate thread
+ *
+ * Text is collected in one of two large buffers. When it is full it is handed to the writer thread,
+ * which writes it to the target in a single call, and the other buffer is filled meanwhile. Writing
+ * only waits when the writer is still busy with the previous buffer.
+ *
+ * Nothing reaches the target before the buffer is full, unless it is flushed explicitly with
+ * pubsync, std::ostream::flush or finish.
+ */
+class AsyncWriteBuffer : public std::streambuf {
+  public:
+   static constexpr std::size_t default_buffer_size = std::size_t{4} << 20U;
+
+   /**
+    * @brief Write into target
+    *
+    * @param target receives the text, must outlive this buffer and must not be used by anyone else
+    * until finish
+    * @param buffer_size size of each of the two buffers
+    */
+   explicit AsyncWriteBuffer(std::streambuf* target, std::size_t buffer_size = default_buffer_size);
+   ~AsyncWriteBuffer() override;
+   AsyncWriteBuffer(AsyncWriteBuffer const&) = delete;
+   AsyncWriteBuffer(AsyncWriteBuffer&&) = delete;
+   AsyncWriteBuffer& operator=(AsyncWriteBuffer const&) = delete;
+   AsyncWriteBuffer& operator=(AsyncWriteBuffer&&) = delete;
+
+   /**
+    * @brief Write the rest and stop the writer thread, nothing can be written afterwards
+    *
+    * @return false if writing to the target failed
+    */
+   bool finish();
+
+  protected:
+   int_type overflow(int_type ch) override;
+   int sync() override;
+   /**
+    * @brief Only reports the position, the target position plus everything written since
+    *
+    */
+   pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+
+  private:
+   [[nodiscard]] bool hand_over();
+   [[nodiscard]] bool wait_written();
+   void write();
+
+   std::streambuf* target_;
+   std::vector<char> filling_;  /// the put area
+   std::vector<char> writing_;  /// handed to the writer thread
+   std::size_t pending_ = 0;    /// bytes of writing_ the writer has not written yet
+   std::uintmax_t position_ = 0;  /// target position of the put area
+   std::mutex mutex_;
+   std::condition_variable handed_;   /// a buffer was handed over or the writer has to stop
+   std::condition_variable written_;  /// the writer is done with writing_
+   bool stop_ = false;
+   bool failed_ = false;
+   bool finished_ = false;
+   std::thread writer_;
+};
@@ -0,0 +1,252 @@
+#include "batch.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <set>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include "translator.h"
+
+#if defined(_WIN32)
+#include <cstdio>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace fs = std::filesystem;
+using Logalizer::Config::JsonConfigParser;
+using Logalizer::Config::path_vars;
+
+namespace {
+// input, trimmed log, translation file and checkpoint of one translation
+constexpr unsigned files_per_translation = 4;
+// standard streams, configuration, watchers and the files of executed commands
+constexpr unsigned reserved_files = 16;
+
+bool is_pattern(std::string_view name)
+{
+   return name.find_first_of("*?") != std::string_view::npos;
+}
+
+bool matches(std::string_view pattern, std::string_view name)
+{
+   // iterative wildcard match, backtracks only to the last *
+   std::size_t p = 0;
+   std::size_t n = 0;
+   std::size_t star = std::string_view::npos;
+   std::size_t star_n = 0;
+   while (n < name.size()) {
+      if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+         ++p;
+         ++n;
+      }
+      else if (p < pattern.size() && pattern[p] == '*') {
+         star = p++;
+         star_n = n;
+      }
+      else if (star != std::string_view::npos) {
+         p = star + 1;
+         n = ++star_n;
+      }
+      else {
+         return false;
+      }
+   }
+   while (p < pattern.size() && pattern[p] == '*') {
+      ++p;
+   }
+   return p == pattern.size();
+}
+
+std::vector<std::string> match_files(fs::path const& pattern)
+{
+   const fs::path dir = pattern.has_parent_path() ? pattern.parent_path() : fs::path(".");
+   const std::string name = pattern.filename().string();
+   std::vector<std::string> files;
+   std::error_code error;
+   for (fs::directory_iterator it(dir, error), end; !error && it != end; it.increment(error)) {
+      if (it->is_regular_file(error) && matches(name, it->path().filename().string())) {
+         files.push_back((pattern.has_parent_path() ? it->path() : it->path().filename()).string());
+      }
+   }
+   std::sort(begin(files), end(files));
+   return files;
+}
+}  // namespace
+
+std::vector<std::string> expand_inputs(std::vector<std::string> const& inputs)
+{
+   std::vector<std::string> files;
+   std::unordered_set<std::string> seen;
+   auto add = [&](std::string const& file) {
+      if (seen.insert(file).second) {
+         files.push_back(file);
+      }
+   };
+   for (auto const& input : inputs) {
+      const fs::path path(input);
+      if (!is_pattern(path.filename().string())) {
+         add(input);
+         continue;
+      }
+      const auto matched = match_files(path);
+      if (matched.empty()) {
+         add(input);
+      }
+      std::for_each(begin(matched), end(matched), add);
+   }
+   return files;
+}
+
+bool read_file_list(std::string const& list_file, std::vector<std::string>* entries)
+{
+   std::ifstream list(list_file);
+   if (!list) {
+      return false;
+   }
+   for (std::string line; std::getline(list, line);) {
+      const auto first = line.find_first_not_of(" \t");
+      const auto last = line.find_last_not_of(" \t\r");
+      if (first == std::string::npos || line[first] == '#') {
+         continue;
+      }
+      entries->push_back(line.substr(first, last - first + 1));
+   }
+   return !list.bad();
+}
+
+path_vars get_path_vars(std::string const& log_file)
+{
+   fs::path log_file_path = log_file;
+   path_vars path_details;
+   path_details.dir = log_file_path.parent_path().string();
+   path_details.file = log_file_path.filename().string();
+   path_details.file_no_ext = fs::path(path_details.file).replace_extension("").string();
+   return path_details;
+}
+
+void backup_if_not_exists(std::string const& original, std::string const& backup)
+{
+   if (original.empty() || backup.empty()) {
+      return;
+   }
+
+   try {
+      fs::create_directories(fs::path(backup).remove_filename());
+      if (!fs::exists(backup)) {
+         fs::copy_file(original, backup);
+      }
+   }
+   catch (std::exception& e) {
+      std::cerr << "Backup failed : " << e.what();
+   }
+}
+
+unsigned max_open_translations()
+{
+#if defined(_WIN32)
+   const auto limit = static_cast<unsigned long long>(_getmaxstdio());
+#else
+   rlimit limits{};
+   if (getrlimit(RLIMIT_NOFILE, &limits) != 0 || limits.rlim_cur == RLIM_INFINITY) {
+      return std::numeric_limits<unsigned>::max();
+   }
+   const auto limit = static_cast<unsigned long long>(limits.rlim_cur);
+#endif
+   if (limit <= reserved_files + files_per_translation) {
+      return 1;
+   }
+   return static_cast<unsigned>(std::min<unsigned long long>((limit - reserved_files) / files_per_translation,
+                                                             std::numeric_limits<unsigned>::max()));
+}
+
+void BatchTranslator::set_jobs(unsigned jobs) noexcept
+{
+   jobs_ = jobs == 0 ? std::max(1U, std::thread::hardware_concurrency()) : jobs;
+}
+
+bool BatchTranslator::shared_translation_file(std::vector<std::string> const& log_files) const
+{
+   JsonConfigParser config = config_;
+   std::set<fs::path> translation_files;
+   for (auto const& log_file : log_files) {
+      config.set_path_variables(get_path_vars(log_file));
+      if (!translation_files.insert(fs::absolute(config.get_translation_file()).lexically_normal()).second) {
+         return true;
+      }
+   }
+   return false;
+}
+
+bool BatchTranslator::translate_one(JsonConfigParser* config, std::string const& log_file)
+{
+   const auto start = std::chrono::steady_clock::now();
+   if (!fs::exists(log_file)) {
+      // removed after the batch was listed
+      std::lock_guard lock(mutex_);
+      std::cerr << log_file << " : not available\n";
+      return false;
+   }
+   config->set_path_variables(get_path_vars(log_file));
+   backup_if_not_exists(log_file, config->get_backup_file());
+
+   Translator translator(*config);
+   translator.set_threads(threads_);
+   translator.set_resume(resume_);
+   translator.set_compress_trimmed(compress_trimmed_);
+   if (collect_stats_) {
+      translator.enable_stats();
+   }
+   try {
+      translator.translate_file(log_file);
+   }
+   catch (std::exception& e) {
+      std::lock_guard lock(mutex_);
+      std::cerr << log_file << " : translation failed\n" << e.what() << "\n";
+      return false;
+   }
+   const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+   std::lock_guard lock(mutex_);
+   if (collect_stats_) {
+      stats_.merge(translator.get_stats());
+   }
+   std::cout << '[' << elapsed.count() << "ms] " << log_file << " -> " << config->get_translation_file() << '\n';
+   // commands like plantuml may write to a shared place, they run one at a time
+   translator.execute_commands();
+   return true;
+}
+
+std::size_t BatchTranslator::translate(std::vector<std::string> const& log_files)
+{
+   unsigned jobs = std::min({jobs_, max_open_translations(), static_cast<unsigned>(log_files.size())});
+   if (jobs > 1 && shared_translation_file(log_files)) {
+      std::cerr << "[warn] logs share a translation file, they are translated one after the other\n";
+      jobs = 1;
+   }
+
+   std::atomic_size_t next{0};
+   std::atomic_size_t failed{0};
+   auto work = [&]() {
+      // every job expands the path variables in a copy of its own
+      JsonConfigParser config = config_;
+      for (auto i = next++; i < log_files.size(); i = next++) {
+         if (!translate_one(&config, log_files[i])) {
+            ++failed;
+         }
+      }
+   };
+
+   std::vector<std::thread> workers;
+   for (unsigned i = 1; i < jobs; ++i) {
+      workers.emplace_back(work);
+   }
+   work();
+   std::for_each(begin(workers), end(workers), [](auto& worker) { worker.join(); });
+   return failed;
+}
@@ -0,0 +1,140 @@
+#pragma once
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "config_types.h"
+#include "jsonconfigparser.h"
+#include "translate_stats.h"
+
+/**
+ * @brief Replace the inputs that contain * or ? in their file name with the files they match
+ *
+ * Only the file name is matched, wildcards in the directory part are taken literally. The files of one
+ * pattern are sorted, files given more than once are kept at their first position. A pattern that
+ * matches nothing is kept as it is, so the caller reports it like any other missing file.
+ *
+ * @param inputs file names and patterns
+ * @return file names
+ */
+[[nodiscard]] std::vector<std::string> expand_inputs(std::vector<std::string> const& inputs);
+
+/**
+ * @brief Read a list of inputs, one per line
+ *
+ * Empty lines and lines starting with # are skipped.
+ *
+ * @param list_file
+ * @param entries the inputs are appended to entries
+ * @return false if list_file cannot be read
+ */
+[[nodiscard]] bool read_file_list(std::string const& list_file, std::vector<std::string>* entries);
+
+/**
+ * @brief Get the values of the path variables of a log
+ *
+ * @param log_file
+ * @return directory, name and name without extension of log_file
+ */
+[[nodiscard]] Logalizer::Config::path_vars get_path_vars(std::string const& log_file);
+
+/**
+ * @brief Copy original to backup unless backup exists, does nothing if either is empty
+ *
+ * @param original
+ * @param backup
+ */
+void backup_if_not_exists(std::string const& original, std::string const& backup);
+
+/**
+ * @brief Number of logs that can be translated at once without running out of file descriptors
+ *
+ * @return at least 1
+ */
+[[nodiscard]] unsigned max_open_translations();
+
+/**
+ * @brief BatchTranslator translates many logs with one loaded configuration
+ *
+ * The configuration is read and compiled once. Every job works on its own copy of it and only expands
+ * the path variables again for each log, see ConfigParser::set_path_variables. Each log is backed up,
+ * translated and its commands are executed, like a single log given on the command line.
+ */
+class BatchTranslator {
+  public:
+   /**
+    * @brief Translate with config
+    *
+    * @param config loaded configuration, must outlive this BatchTranslator
+    */
+   explicit BatchTranslator(Logalizer::Config::JsonConfigParser const& config) : config_(config)
+   {
+   }
+
+   /**
+    * @brief Set the number of logs translated at once
+    *
+    * The number is limited by max_open_translations. Logs whose translation files would be the same
+    * are always translated one after the other.
+    *
+    * @param jobs 0 translates one log per hardware thread
+    */
+   void set_jobs(unsigned jobs) noexcept;
+
+   /**
+    * @brief Set the number of threads translating each log, see Translator::set_threads
+    *
+    * @param threads
+    */
+   void set_threads(unsigned threads) noexcept
+   {
+      threads_ = threads;
+   }
+
+   void set_resume(bool resume) noexcept
+   {
+      resume_ = resume;
+   }
+
+   void set_compress_trimmed(bool compress) noexcept
+   {
+      compress_trimmed_ = compress;
+   }
+
+   void enable_stats() noexcept
+   {
+      collect_stats_ = true;
+   }
+
+   /**
+    * @brief Translate log_files
+    *
+    * A log that fails is reported on std::cerr and does not stop the others.
+    *
+    * @param log_files
+    * @return number of logs that could not be translated
+    */
+   [[nodiscard]] std::size_t translate(std::vector<std::string> const& log_files);
+
+   /**
+    * @brief Get the stats of all logs translated so far, empty unless enabled with enable_stats
+    *
+    */
+   [[nodiscard]] translate_stats const& get_stats() const noexcept
+   {
+      return stats_;
+   }
+
+  private:
+   [[nodiscard]] bool shared_translation_file(std::vector<std::string> const& log_files) const;
+   [[nodiscard]] bool translate_one(Logalizer::Config::JsonConfigParser* config, std::string const& log_file);
+
+   Logalizer::Config::JsonConfigParser const& config_;
+   unsigned jobs_ = 1;
+   unsigned threads_ = 1;
+   bool resume_ = false;
+   bool compress_trimmed_ = false;
+   bool collect_stats_ = false;
+   std::mutex mutex_;  /// guards stats_, the console and the execute commands
+   translate_stats stats_;
+};
@@ -0,0 +1,112 @@
+#include "checkpoint.h"
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+constexpr std::string_view magic = "LZCKPT1\n";
+}  // namespace
+
+CheckpointWriter::CheckpointWriter(std::string file_name)
+    : file_name_(std::move(file_name)), temp_file_name_(file_name_ + ".tmp")
+{
+   file_.open(temp_file_name_, std::ios::binary | std::ios::trunc);
+   file_.write(magic.data(), static_cast<std::streamsize>(magic.size()));
+}
+
+void CheckpointWriter::put(std::uint64_t value)
+{
+   // little endian on every platform, a checkpoint can be resumed on another machine
+   std::array<char, sizeof(value)> bytes{};
+   for (auto& byte : bytes) {
+      byte = static_cast<char>(value & 0xFFU);
+      value >>= 8U;
+   }
+   file_.write(bytes.data(), bytes.size());
+}
+
+void CheckpointWriter::put(std::string_view text)
+{
+   put(static_cast<std::uint64_t>(text.size()));
+   file_.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+bool CheckpointWriter::commit()
+{
+   file_.close();
+   if (!file_ || !sync_file(temp_file_name_)) {
+      return false;
+   }
+   std::error_code error;
+   fs::rename(temp_file_name_, file_name_, error);
+   return !error;
+}
+
+CheckpointReader::CheckpointReader(std::string const& file_name) : file_(file_name, std::ios::binary | std::ios::ate)
+{
+   remaining_ = file_ ? static_cast<std::uint64_t>(file_.tellg()) : 0;
+   file_.seekg(0);
+   std::array<char, magic.size()> header{};
+   file_.read(header.data(), header.size());
+   if (!file_ || std::string_view(header.data(), header.size()) != magic) {
+      file_.setstate(std::ios::failbit);
+   }
+   remaining_ -= std::min<std::uint64_t>(remaining_, magic.size());
+}
+
+bool CheckpointReader::get(std::uint64_t* value)
+{
+   std::array<unsigned char, sizeof(*value)> bytes{};
+   if (!file_.read(reinterpret_cast<char*>(bytes.data()), bytes.size())) {
+      return false;
+   }
+   remaining_ -= bytes.size();
+   *value = 0;
+   for (auto byte = bytes.rbegin(); byte != bytes.rend(); ++byte) {
+      *value = (*value << 8U) | *byte;
+   }
+   return true;
+}
+
+bool CheckpointReader::get(std::string* text)
+{
+   std::uint64_t size = 0;
+   if (!get(&size)) {
+      return false;
+   }
+   // a damaged size must not allocate more than the rest of the file
+   if (size > remaining_) {
+      file_.setstate(std::ios::failbit);
+      return false;
+   }
+   remaining_ -= size;
+   text->resize(static_cast<std::size_t>(size));
+   return static_cast<bool>(file_.read(text->data(), static_cast<std::streamsize>(size)));
+}
+
+#if !defined(_WIN32)
+bool sync_file(std::string const& file_name)
+{
+   const int fd = ::open(file_name.c_str(), O_RDONLY);
+   if (fd < 0) {
+      return false;
+   }
+   const bool synced = ::fsync(fd) == 0;
+   ::close(fd);
+   return synced;
+}
+#else
+bool sync_file(std::string const&)
+{
+   // closed files are written through by the cache manager
+   return true;
+}
+#endif
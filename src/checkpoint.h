@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief CheckpointWriter stores a checkpoint as a sequence of numbers and strings
+ *
+ * The values are written to a temporary file next to the checkpoint, commit renames it over the
+ * checkpoint. A reader sees either the previous checkpoint or the complete new one, never a mix.
+ */
+class CheckpointWriter {
+  public:
+   /**
+    * @brief Start a new checkpoint that replaces file_name on commit
+    *
+    * @param file_name
+    */
+   explicit CheckpointWriter(std::string file_name);
+
+   void put(std::uint64_t value);
+   void put(std::string_view text);
+
+   /**
+    * @brief Make the checkpoint durable and replace the previous one
+    *
+    * @return false if the checkpoint could not be written, the previous one is kept
+    */
+   [[nodiscard]] bool commit();
+
+  private:
+   std::string file_name_;
+   std::string temp_file_name_;
+   std::ofstream file_;
+};
+
+/**
+ * @brief CheckpointReader reads the values of a checkpoint in the order they were written
+ *
+ */
+class CheckpointReader {
+  public:
+   explicit CheckpointReader(std::string const& file_name);
+
+   /**
+    * @brief Read the next value
+    *
+    * @return false if the checkpoint is missing, not a checkpoint or ends early
+    */
+   [[nodiscard]] bool get(std::uint64_t* value);
+   [[nodiscard]] bool get(std::string* text);
+
+  private:
+   std::ifstream file_;
+   std::uint64_t remaining_ = 0;  /// bytes not read yet
+};
+
+/**
+ * @brief Write the data of a file that is still cached by the operating system to its storage
+ *
+ * @param file_name
+ * @return false if the file could not be synced
+ */
+bool sync_file(std::string const& file_name);
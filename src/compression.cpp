@@ -0,0 +1,730 @@
+#include "compression.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <stdexcept>
+
+#if defined(LOGALIZER_WITH_ZLIB)
+#include <zlib.h>
+#endif
+#if defined(LOGALIZER_WITH_ZSTD)
+#include <zstd.h>
+#endif
+#if defined(LOGALIZER_WITH_LZ4)
+#include <lz4frame.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+constexpr std::size_t read_size = std::size_t{1} << 20U;       /// compressed bytes read at once
+constexpr std::size_t block_size = std::size_t{1} << 20U;      /// decoded bytes handed out at once
+constexpr std::size_t queue_depth = 8;                         /// blocks decoded ahead of the reader
+constexpr std::size_t batch_size = std::size_t{4} << 20U;      /// decoded bytes per thread and parallel batch
+constexpr std::size_t max_window = std::size_t{16} << 20U;     /// larger zstd frames are streamed
+constexpr std::size_t max_frame_size = std::size_t{64} << 20U;  /// larger zstd frames are not buffered
+constexpr std::size_t frame_size = std::size_t{4} << 20U;      /// text compressed into one block
+constexpr std::size_t bgzf_max_size = std::size_t{64} << 10U;  /// bgzip blocks hold at most this much text
+
+/**
+ * @brief Thrown in the decoding thread to unwind it when the Decompressor is destroyed early
+ *
+ */
+struct stopped {};
+
+std::runtime_error damaged(compression format, std::string_view detail)
+{
+   return std::runtime_error(std::string(to_string(format)) + " input is damaged : " + std::string(detail));
+}
+
+std::runtime_error unsupported(compression format)
+{
+   return std::runtime_error(std::string(to_string(format)) + " is not supported by this build");
+}
+
+[[maybe_unused]] unsigned byte_at(std::string_view data, std::size_t index)
+{
+   return static_cast<unsigned char>(data[index]);
+}
+
+[[maybe_unused]] std::uint32_t little_endian(std::string_view data, std::size_t index, std::size_t bytes)
+{
+   std::uint32_t value = 0;
+   for (std::size_t i = bytes; i-- > 0;) {
+      value = (value << 8U) | byte_at(data, index + i);
+   }
+   return value;
+}
+
+#if defined(LOGALIZER_WITH_ZLIB)
+unsigned char* bytes(char* data)
+{
+   return reinterpret_cast<unsigned char*>(data);
+}
+
+unsigned char* bytes(const char* data)
+{
+   // zlib does not write through next_in, it is only declared without const
+   return reinterpret_cast<unsigned char*>(const_cast<char*>(data));
+}
+
+/**
+ * @brief Check if data starts with a bgzip block, a gzip member with a BC extra field holding its size
+ *
+ */
+bool is_bgzf(std::string_view data)
+{
+   return data.size() >= 18 && byte_at(data, 0) == 0x1F && byte_at(data, 1) == 0x8B && byte_at(data, 2) == 8 &&
+          (byte_at(data, 3) & 4U) != 0 && little_endian(data, 10, 2) >= 6 && data[12] == 'B' && data[13] == 'C' &&
+          little_endian(data, 14, 2) == 2;
+}
+
+/**
+ * @brief Check that a bgzip block of the given size holds its extra field and the trailer after it
+ *
+ */
+bool is_bgzf_size(std::string_view data, std::size_t size)
+{
+   return size >= 12 + little_endian(data, 10, 2) + 8;
+}
+
+void inflate_bgzf_block(std::string_view block, std::string* out)
+{
+   if (block.size() < 12 || !is_bgzf_size(block, block.size())) {
+      throw damaged(compression::gzip, "bgzip block header");
+   }
+   const std::size_t header = 12 + little_endian(block, 10, 2);
+   const std::uint32_t crc = little_endian(block, block.size() - 8, 4);
+   const std::size_t size = little_endian(block, block.size() - 4, 4);
+   if (size > bgzf_max_size) {
+      throw damaged(compression::gzip, "bgzip block size");
+   }
+   if (size == 0) {
+      // end of file marker
+      return;
+   }
+
+   const std::size_t start = out->size();
+   out->resize(start + size);
+   z_stream stream{};
+   if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+      throw std::runtime_error("gzip decoder could not be initialized");
+   }
+   stream.next_in = bytes(block.data() + header);
+   stream.avail_in = static_cast<uInt>(block.size() - header - 8);
+   stream.next_out = bytes(out->data() + start);
+   stream.avail_out = static_cast<uInt>(size);
+   const int result = inflate(&stream, Z_FINISH);
+   inflateEnd(&stream);
+   if (result != Z_STREAM_END || stream.avail_out != 0 ||
+       crc32(0, bytes(out->data() + start), static_cast<uInt>(size)) != crc) {
+      throw damaged(compression::gzip, "bgzip block does not match its size or checksum");
+   }
+}
+#endif
+
+#if defined(LOGALIZER_WITH_ZSTD)
+void decode_zstd_frame(std::string_view frame, std::string* out)
+{
+   const auto size = static_cast<std::size_t>(ZSTD_getFrameContentSize(frame.data(), frame.size()));
+   const std::size_t start = out->size();
+   out->resize(start + size);
+   const std::size_t written = ZSTD_decompress(out->data() + start, size, frame.data(), frame.size());
+   if (ZSTD_isError(written)) {
+      throw damaged(compression::zstd, ZSTD_getErrorName(written));
+   }
+   if (written != size) {
+      throw damaged(compression::zstd, "frame does not match its size");
+   }
+}
+#endif
+}  // namespace
+
+compression detect_compression(std::string const& file_name)
+{
+   std::error_code error;
+   if (!fs::is_regular_file(file_name, error)) {
+      // reading the magic bytes would consume them from a pipe
+      return compression::none;
+   }
+   std::array<char, 4> magic{};
+   std::ifstream file(file_name, std::ios::binary);
+   if (!file.read(magic.data(), magic.size())) {
+      return compression::none;
+   }
+   const std::string_view head(magic.data(), magic.size());
+   if (byte_at(head, 0) == 0x1F && byte_at(head, 1) == 0x8B) {
+      return compression::gzip;
+   }
+   if (head == std::string_view("\x28\xB5\x2F\xFD", 4) ||
+       ((byte_at(head, 0) & 0xF0U) == 0x50 && head.substr(1) == std::string_view("\x2A\x4D\x18", 3))) {
+      // a zstd frame, or a skippable frame that pzstd writes first
+      return compression::zstd;
+   }
+   if (head == std::string_view("\x04\x22\x4D\x18", 4)) {
+      return compression::lz4;
+   }
+   return compression::none;
+}
+
+bool is_supported(compression format) noexcept
+{
+   switch (format) {
+      case compression::none:
+         return true;
+      case compression::gzip:
+#if defined(LOGALIZER_WITH_ZLIB)
+         return true;
+#else
+         return false;
+#endif
+      case compression::zstd:
+#if defined(LOGALIZER_WITH_ZSTD)
+         return true;
+#else
+         return false;
+#endif
+      case compression::lz4:
+#if defined(LOGALIZER_WITH_LZ4)
+         return true;
+#else
+         return false;
+#endif
+   }
+   return false;
+}
+
+std::string_view to_string(compression format) noexcept
+{
+   switch (format) {
+      case compression::gzip:
+         return "gzip";
+      case compression::zstd:
+         return "zstd";
+      case compression::lz4:
+         return "lz4";
+      case compression::none:
+         break;
+   }
+   return "none";
+}
+
+Decompressor::Decompressor(std::string const& file_name, compression format, unsigned threads)
+    : format_(format), threads_(std::max(1U, threads)), input_(file_name, std::ios::binary)
+{
+   if (!is_supported(format_)) {
+      throw unsupported(format_);
+   }
+   producer_ = std::thread([this]() { produce(); });
+}
+
+Decompressor::~Decompressor()
+{
+   {
+      std::lock_guard lock(mutex_);
+      stop_ = true;
+   }
+   space_.notify_all();
+   producer_.join();
+}
+
+bool Decompressor::read(std::string* lines)
+{
+   std::unique_lock lock(mutex_);
+   ready_.wait(lock, [this]() { return !blocks_.empty() || done_; });
+   if (blocks_.empty()) {
+      if (error_) {
+         std::rethrow_exception(error_);
+      }
+      return false;
+   }
+   *lines = std::move(blocks_.front());
+   blocks_.pop_front();
+   space_.notify_one();
+   return true;
+}
+
+void Decompressor::produce()
+{
+   try {
+      switch (format_) {
+         case compression::gzip:
+            decode_gzip();
+            break;
+         case compression::zstd:
+            decode_zstd();
+            break;
+         case compression::lz4:
+            decode_lz4();
+            break;
+         case compression::none: {
+            std::string input(read_size, '\0');
+            for (std::size_t filled; (filled = read_input(input.data(), input.size())) != 0;) {
+               emit(std::string_view(input.data(), filled));
+            }
+            break;
+         }
+      }
+      emit({}, true);
+   }
+   catch (stopped const&) {
+      // the reader is gone, nobody waits for the rest
+   }
+   catch (...) {
+      std::lock_guard lock(mutex_);
+      error_ = std::current_exception();
+   }
+   {
+      std::lock_guard lock(mutex_);
+      done_ = true;
+   }
+   ready_.notify_all();
+}
+
+std::size_t Decompressor::read_input(char* data, std::size_t size)
+{
+   input_.read(data, static_cast<std::streamsize>(size));
+   return static_cast<std::size_t>(input_.gcount());
+}
+
+void Decompressor::emit(std::string_view decoded, bool last)
+{
+   pending_.append(decoded);
+   if (pending_.size() < block_size && !last) {
+      return;
+   }
+   // npos + 1 is 0, a line longer than a block waits for its end
+   const std::size_t end = last ? pending_.size() : pending_.rfind('\n') + 1;
+   if (end == 0) {
+      return;
+   }
+   std::string lines = std::move(pending_);
+   pending_.assign(lines, end);
+   lines.resize(end);
+
+   std::unique_lock lock(mutex_);
+   space_.wait(lock, [this]() { return blocks_.size() < queue_depth || stop_; });
+   if (stop_) {
+      throw stopped{};
+   }
+   blocks_.push_back(std::move(lines));
+   ready_.notify_one();
+}
+
+template <typename Decode>
+void Decompressor::decode_parallel(std::vector<std::string_view> const& frames, Decode const& decode)
+{
+   // contiguous groups of frames are decoded concurrently and emitted in input order
+   const std::size_t groups = std::min<std::size_t>(threads_, frames.size());
+   auto decode_group = [&frames, &decode](std::size_t begin, std::size_t end) {
+      std::string decoded;
+      for (std::size_t frame = begin; frame < end; ++frame) {
+         decode(frames[frame], &decoded);
+      }
+      return decoded;
+   };
+   if (groups <= 1) {
+      emit(decode_group(0, frames.size()));
+      return;
+   }
+
+   std::vector<std::future<std::string>> decoded;
+   for (std::size_t group = 0; group < groups; ++group) {
+      decoded.push_back(std::async(std::launch::async, decode_group, frames.size() * group / groups,
+                                   frames.size() * (group + 1) / groups));
+   }
+   for (auto& group : decoded) {
+      emit(group.get());
+   }
+}
+
+void Decompressor::decode_gzip()
+{
+#if defined(LOGALIZER_WITH_ZLIB)
+   std::string input(read_size, '\0');
+   std::size_t filled = read_input(input.data(), input.size());
+   if (is_bgzf(std::string_view(input.data(), filled))) {
+      decode_bgzf(std::move(input), filled);
+      return;
+   }
+
+   z_stream stream{};
+   // 32 detects the gzip header
+   if (inflateInit2(&stream, MAX_WBITS + 32) != Z_OK) {
+      throw std::runtime_error("gzip decoder could not be initialized");
+   }
+   std::unique_ptr<z_stream, int (*)(z_stream*)> end_stream(&stream, inflateEnd);
+   std::string output(block_size, '\0');
+   bool member_open = false;
+   stream.next_in = bytes(input.data());
+   stream.avail_in = static_cast<uInt>(filled);
+   for (;;) {
+      if (stream.avail_in == 0) {
+         filled = read_input(input.data(), input.size());
+         if (filled == 0) {
+            break;
+         }
+         stream.next_in = bytes(input.data());
+         stream.avail_in = static_cast<uInt>(filled);
+      }
+      stream.next_out = bytes(output.data());
+      stream.avail_out = static_cast<uInt>(output.size());
+      const int result = inflate(&stream, Z_NO_FLUSH);
+      if (result != Z_OK && result != Z_STREAM_END) {
+         throw damaged(format_, stream.msg != nullptr ? stream.msg : "inflate failed");
+      }
+      emit(std::string_view(output.data(), output.size() - stream.avail_out));
+      member_open = (result == Z_OK);
+      if (result == Z_STREAM_END) {
+         // another member may follow, like in files joined with cat
+         inflateReset(&stream);
+      }
+   }
+   if (member_open) {
+      throw damaged(format_, "unexpected end of file");
+   }
+#else
+   throw unsupported(format_);
+#endif
+}
+
+void Decompressor::decode_bgzf([[maybe_unused]] std::string input, [[maybe_unused]] std::size_t filled)
+{
+#if defined(LOGALIZER_WITH_ZLIB)
+   std::vector<std::string_view> blocks;
+   const std::size_t batch_limit = batch_size * threads_;
+   for (;;) {
+      std::size_t position = 0;
+      std::size_t batch = 0;
+      while (filled - position >= 18) {
+         const std::string_view rest(input.data() + position, filled - position);
+         if (!is_bgzf(rest)) {
+            throw damaged(format_, "member is not a bgzip block");
+         }
+         const std::size_t size = little_endian(rest, 16, 2) + std::size_t{1};
+         if (!is_bgzf_size(rest, size)) {
+            // also keeps the trailer read below inside the block
+            throw damaged(format_, "bgzip block size");
+         }
+         if (size > rest.size()) {
+            break;
+         }
+         blocks.push_back(rest.substr(0, size));
+         batch += little_endian(rest, size - 4, 4);
+         position += size;
+         if (batch >= batch_limit) {
+            decode_parallel(blocks, inflate_bgzf_block);
+            blocks.clear();
+            batch = 0;
+         }
+      }
+      decode_parallel(blocks, inflate_bgzf_block);
+      blocks.clear();
+
+      // the incomplete block is completed by the next read
+      input.erase(0, position);
+      filled -= position;
+      input.resize(filled + read_size);
+      const std::size_t read = read_input(input.data() + filled, read_size);
+      if (read == 0) {
+         if (filled != 0) {
+            throw damaged(format_, "unexpected end of file");
+         }
+         return;
+      }
+      filled += read;
+   }
+#else
+   throw unsupported(format_);
+#endif
+}
+
+void Decompressor::decode_zstd()
+{
+#if defined(LOGALIZER_WITH_ZSTD)
+   std::string input;
+   std::size_t filled = 0;
+   std::vector<std::string_view> frames;
+   const std::size_t batch_limit = batch_size * threads_;
+   for (;;) {
+      std::size_t position = 0;
+      std::size_t batch = 0;
+      while (position < filled) {
+         const std::string_view rest(input.data() + position, filled - position);
+         const std::size_t size = ZSTD_findFrameCompressedSize(rest.data(), rest.size());
+         if (ZSTD_isError(size)) {
+            // incomplete, completed by the next read
+            break;
+         }
+         const std::string_view frame = rest.substr(0, size);
+         const auto content = ZSTD_getFrameContentSize(frame.data(), frame.size());
+         position += size;
+         if (content == ZSTD_CONTENTSIZE_UNKNOWN || content == ZSTD_CONTENTSIZE_ERROR || content > max_frame_size) {
+            decode_parallel(frames, decode_zstd_frame);
+            frames.clear();
+            batch = 0;
+            stream_zstd(frame, false);
+            continue;
+         }
+         frames.push_back(frame);
+         batch += static_cast<std::size_t>(content);
+         if (batch >= batch_limit) {
+            decode_parallel(frames, decode_zstd_frame);
+            frames.clear();
+            batch = 0;
+         }
+      }
+      decode_parallel(frames, decode_zstd_frame);
+      frames.clear();
+
+      input.erase(0, position);
+      filled -= position;
+      if (filled >= max_window) {
+         // a single frame for a large part of the file, like zstd -T writes, is decoded as a stream
+         stream_zstd(std::string_view(input.data(), filled), true);
+         return;
+      }
+      input.resize(filled + read_size);
+      const std::size_t read = read_input(input.data() + filled, read_size);
+      if (read == 0) {
+         if (filled != 0) {
+            throw damaged(format_, "unexpected end of file");
+         }
+         return;
+      }
+      filled += read;
+   }
+#else
+   throw unsupported(format_);
+#endif
+}
+
+void Decompressor::stream_zstd([[maybe_unused]] std::string_view data, [[maybe_unused]] bool to_end)
+{
+#if defined(LOGALIZER_WITH_ZSTD)
+   std::unique_ptr<ZSTD_DCtx, std::size_t (*)(ZSTD_DCtx*)> context(ZSTD_createDCtx(), ZSTD_freeDCtx);
+   std::string input;
+   std::string output(block_size, '\0');
+   std::size_t hint = 0;
+   for (;;) {
+      ZSTD_inBuffer in{data.data(), data.size(), 0};
+      for (bool full = true; in.pos < in.size || full;) {
+         ZSTD_outBuffer out{output.data(), output.size(), 0};
+         hint = ZSTD_decompressStream(context.get(), &out, &in);
+         if (ZSTD_isError(hint)) {
+            throw damaged(format_, ZSTD_getErrorName(hint));
+         }
+         emit(std::string_view(output.data(), out.pos));
+         // a full output buffer may leave decoded data in the context
+         full = out.pos == out.size;
+      }
+      if (!to_end) {
+         break;
+      }
+      input.resize(read_size);
+      input.resize(read_input(input.data(), input.size()));
+      if (input.empty()) {
+         break;
+      }
+      data = input;
+   }
+   if (hint != 0) {
+      throw damaged(format_, "unexpected end of file");
+   }
+#else
+   throw unsupported(format_);
+#endif
+}
+
+void Decompressor::decode_lz4()
+{
+#if defined(LOGALIZER_WITH_LZ4)
+   LZ4F_dctx* created = nullptr;
+   if (LZ4F_isError(LZ4F_createDecompressionContext(&created, LZ4F_VERSION))) {
+      throw std::runtime_error("lz4 decoder could not be initialized");
+   }
+   std::unique_ptr<LZ4F_dctx, LZ4F_errorCode_t (*)(LZ4F_dctx*)> context(created, LZ4F_freeDecompressionContext);
+   std::string input(read_size, '\0');
+   std::string output(block_size, '\0');
+   std::size_t hint = 0;
+   auto decompress = [&](const char* data, std::size_t* consumed) {
+      std::size_t produced = output.size();
+      hint = LZ4F_decompress(context.get(), output.data(), &produced, data, consumed, nullptr);
+      if (LZ4F_isError(hint)) {
+         throw damaged(format_, LZ4F_getErrorName(hint));
+      }
+      emit(std::string_view(output.data(), produced));
+      return produced == output.size();
+   };
+
+   // frames may be concatenated, the context starts a new one after each
+   for (std::size_t filled; (filled = read_input(input.data(), input.size())) != 0;) {
+      bool full = false;
+      for (std::size_t position = 0; position < filled;) {
+         std::size_t consumed = filled - position;
+         full = decompress(input.data() + position, &consumed);
+         position += consumed;
+      }
+      // a full output buffer may leave decoded data of an unfinished frame in the context
+      for (std::size_t consumed = 0; full && hint != 0; consumed = 0) {
+         full = decompress(nullptr, &consumed);
+      }
+   }
+   if (hint != 0) {
+      throw damaged(format_, "unexpected end of file");
+   }
+#else
+   throw unsupported(format_);
+#endif
+}
+
+struct CompressingBuffer::encoder {
+#if defined(LOGALIZER_WITH_ZLIB)
+   z_stream deflater{};
+   bool deflating = false;
+#endif
+#if defined(LOGALIZER_WITH_ZSTD)
+   std::unique_ptr<ZSTD_CCtx, std::size_t (*)(ZSTD_CCtx*)> zstd{nullptr, ZSTD_freeCCtx};
+#endif
+
+   encoder() = default;
+   encoder(encoder const&) = delete;
+   encoder(encoder&&) = delete;
+   encoder& operator=(encoder const&) = delete;
+   encoder& operator=(encoder&&) = delete;
+   ~encoder()
+   {
+#if defined(LOGALIZER_WITH_ZLIB)
+      if (deflating) {
+         deflateEnd(&deflater);
+      }
+#endif
+   }
+};
+
+CompressingBuffer::CompressingBuffer(std::streambuf* target, compression format)
+    : target_(target), format_(format), encoder_(std::make_unique<encoder>())
+{
+   if (!is_supported(format_)) {
+      throw unsupported(format_);
+   }
+#if defined(LOGALIZER_WITH_ZLIB)
+   if (format_ == compression::gzip) {
+      // 16 writes a gzip header
+      if (deflateInit2(&encoder_->deflater, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16, 8,
+                       Z_DEFAULT_STRATEGY) != Z_OK) {
+         throw std::runtime_error("gzip encoder could not be initialized");
+      }
+      encoder_->deflating = true;
+      output_.resize(block_size);
+   }
+#endif
+#if defined(LOGALIZER_WITH_ZSTD)
+   if (format_ == compression::zstd) {
+      encoder_->zstd.reset(ZSTD_createCCtx());
+      output_.resize(ZSTD_compressBound(frame_size));
+   }
+#endif
+   buffer_.resize(frame_size);
+   setp(buffer_.data(), buffer_.data() + buffer_.size());
+}
+
+CompressingBuffer::~CompressingBuffer()
+{
+   finish();
+}
+
+bool CompressingBuffer::finish()
+{
+   if (finished_) {
+      return true;
+   }
+   finished_ = true;
+   const bool compressed = compress(true);
+   setp(nullptr, nullptr);
+   return compressed && target_->pubsync() == 0;
+}
+
+CompressingBuffer::int_type CompressingBuffer::overflow(int_type ch)
+{
+   if (finished_ || !compress(false)) {
+      return traits_type::eof();
+   }
+   if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(ch);
+      pbump(1);
+   }
+   return traits_type::not_eof(ch);
+}
+
+int CompressingBuffer::sync()
+{
+   // gzip may still hold back the last few KiB, they are written by finish
+   if (finished_ || !compress(false)) {
+      return -1;
+   }
+   return target_->pubsync();
+}
+
+bool CompressingBuffer::compress(bool end)
+{
+   const std::string_view text(pbase(), static_cast<std::size_t>(pptr() - pbase()));
+   setp(buffer_.data(), buffer_.data() + buffer_.size());
+   if (text.empty() && !(end && (format_ == compression::gzip || !written_))) {
+      return true;
+   }
+   written_ = true;
+
+   switch (format_) {
+      case compression::gzip: {
+#if defined(LOGALIZER_WITH_ZLIB)
+         auto& stream = encoder_->deflater;
+         stream.next_in = bytes(text.data());
+         stream.avail_in = static_cast<uInt>(text.size());
+         do {
+            stream.next_out = bytes(output_.data());
+            stream.avail_out = static_cast<uInt>(output_.size());
+            deflate(&stream, end ? Z_FINISH : Z_NO_FLUSH);
+            if (!write(std::string_view(output_.data(), output_.size() - stream.avail_out))) {
+               return false;
+            }
+         } while (stream.avail_out == 0);
+#endif
+         break;
+      }
+      case compression::zstd: {
+#if defined(LOGALIZER_WITH_ZSTD)
+         const std::size_t size =
+             ZSTD_compress2(encoder_->zstd.get(), output_.data(), output_.size(), text.data(), text.size());
+         if (ZSTD_isError(size) || !write(std::string_view(output_.data(), size))) {
+            return false;
+         }
+#endif
+         break;
+      }
+      case compression::lz4: {
+#if defined(LOGALIZER_WITH_LZ4)
+         LZ4F_preferences_t preferences{};
+         preferences.frameInfo.contentSize = text.size();
+         output_.resize(LZ4F_compressFrameBound(text.size(), &preferences));
+         const std::size_t size =
+             LZ4F_compressFrame(output_.data(), output_.size(), text.data(), text.size(), &preferences);
+         if (LZ4F_isError(size) || !write(std::string_view(output_.data(), size))) {
+            return false;
+         }
+#endif
+         break;
+      }
+      case compression::none:
+         return write(text);
+   }
+   return true;
+}
+
+bool CompressingBuffer::write(std::string_view compressed)
+{
+   return target_->sputn(compressed.data(), static_cast<std::streamsize>(compressed.size())) ==
+          static_cast<std::streamsize>(compressed.size());
+}
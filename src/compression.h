@@ -0,0 +1,149 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Compression formats of input files, detected from their first bytes
+ *
+ */
+enum class compression { none, gzip, zstd, lz4 };
+
+/**
+ * @brief Detect the compression of a regular file from its magic bytes
+ *
+ * @param file_name
+ * @return compression::none for uncompressed files, pipes and files that cannot be read
+ */
+[[nodiscard]] compression detect_compression(std::string const& file_name);
+
+/**
+ * @brief Check if this build can read and write a compression format
+ *
+ * @param format
+ * @return true if the library of the format was available at build time
+ */
+[[nodiscard]] bool is_supported(compression format) noexcept;
+
+[[nodiscard]] std::string_view to_string(compression format) noexcept;
+
+/**
+ * @brief Decompressor decodes a compressed file on a separate thread
+ *
+ * The decoded text is handed out in blocks of whole lines, so decoding overlaps with whatever the
+ * reader does with the previous blocks. At most a few blocks are decoded ahead of the reader.
+ *
+ * gzip members and zstd frames may be concatenated. Files split into independent blocks, bgzip
+ * blocks and zstd frames that record their size, are decoded by up to threads threads at once.
+ * Other files are decoded as one stream.
+ */
+class Decompressor {
+  public:
+   /**
+    * @brief Start decoding file_name
+    *
+    * @param file_name
+    * @param format compression of the file, from detect_compression
+    * @param threads number of threads decoding independent blocks
+    * @throws std::runtime_error if the format is not supported by this build
+    */
+   Decompressor(std::string const& file_name, compression format, unsigned threads);
+   ~Decompressor();
+   Decompressor(Decompressor const&) = delete;
+   Decompressor(Decompressor&&) = delete;
+   Decompressor& operator=(Decompressor const&) = delete;
+   Decompressor& operator=(Decompressor&&) = delete;
+
+   /**
+    * @brief Get the next block of decoded lines
+    *
+    * Every block ends with a line terminator, except the last one if the file does not.
+    *
+    * @param lines is set to the next block
+    * @return false when the whole file is decoded
+    * @throws std::runtime_error if the file is damaged or truncated
+    */
+   [[nodiscard]] bool read(std::string* lines);
+
+  private:
+   void produce();
+   [[nodiscard]] std::size_t read_input(char* data, std::size_t size);
+   void emit(std::string_view decoded, bool last = false);
+   template <typename Decode>
+   void decode_parallel(std::vector<std::string_view> const& frames, Decode const& decode);
+   void decode_gzip();
+   void decode_bgzf(std::string input, std::size_t filled);
+   void decode_zstd();
+   void stream_zstd(std::string_view data, bool to_end);
+   void decode_lz4();
+
+   compression format_;
+   unsigned threads_;
+   std::ifstream input_;
+   std::string pending_;  /// decoded text after the last complete line
+   std::mutex mutex_;
+   std::condition_variable ready_;  /// a block was decoded or decoding ended
+   std::condition_variable space_;  /// the reader took a block
+   std::deque<std::string> blocks_;
+   bool done_ = false;
+   bool stop_ = false;
+   std::exception_ptr error_;
+   std::thread producer_;
+};
+
+/**
+ * @brief CompressingBuffer compresses everything written to it into another stream buffer
+ *
+ * Text is compressed in blocks of a few MiB. zstd and lz4 write every block as a frame of its own.
+ * Decompressor decodes zstd frames in parallel, lz4 frames one after the other as a stream.
+ * gzip writes a single member.
+ */
+class CompressingBuffer : public std::streambuf {
+  public:
+   /**
+    * @brief Compress into target
+    *
+    * @param target receives the compressed data, must outlive this buffer
+    * @param format
+    * @throws std::runtime_error if the format is not supported by this build
+    */
+   CompressingBuffer(std::streambuf* target, compression format);
+   ~CompressingBuffer() override;
+   CompressingBuffer(CompressingBuffer const&) = delete;
+   CompressingBuffer(CompressingBuffer&&) = delete;
+   CompressingBuffer& operator=(CompressingBuffer const&) = delete;
+   CompressingBuffer& operator=(CompressingBuffer&&) = delete;
+
+   /**
+    * @brief Compress the rest and end the compressed stream, nothing can be written afterwards
+    *
+    * @return false if writing to the target failed
+    */
+   bool finish();
+
+  protected:
+   int_type overflow(int_type ch) override;
+   int sync() override;
+
+  private:
+   struct encoder;
+   [[nodiscard]] bool compress(bool end);
+   [[nodiscard]] bool write(std::string_view compressed);
+
+   std::streambuf* target_;
+   compression format_;
+   std::string buffer_;
+   std::string output_;
+   std::unique_ptr<encoder> encoder_;
+   bool written_ = false;  /// a block was compressed
+   bool finished_ = false;
+};
@@ -0,0 +1,118 @@
+#include "file_watcher.h"
+#include <array>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+#if !defined(_WIN32)
+#include <sys/stat.h>
+#endif
+
+namespace fs = std::filesystem;
+
+FileWatcher::FileWatcher(std::string file_name, std::chrono::milliseconds interval)
+    : file_name_(std::move(file_name)), interval_(interval)
+{
+#if defined(__linux__)
+   inotify_ = ::inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+   if (inotify_ >= 0) {
+      watch();
+      if (watch_ < 0) {
+         ::close(inotify_);
+         inotify_ = -1;
+      }
+   }
+#endif
+   // the current state is the baseline for polling
+   static_cast<void>(changed());
+}
+
+FileWatcher::~FileWatcher()
+{
+#if defined(__linux__)
+   if (inotify_ >= 0) {
+      ::close(inotify_);
+   }
+#endif
+}
+
+bool FileWatcher::changed()
+{
+   std::error_code error;
+   const auto size = fs::file_size(file_name_, error);
+   const auto modified = fs::last_write_time(file_name_, error);
+   const bool change = size != size_ || modified != modified_;
+   size_ = size;
+   modified_ = modified;
+   return change;
+}
+
+std::optional<FileWatcher::identity> FileWatcher::identify(std::string const& file_name)
+{
+#if !defined(_WIN32)
+   struct stat status{};
+   if (::stat(file_name.c_str(), &status) != 0) {
+      return std::nullopt;
+   }
+   return identity{static_cast<std::uintmax_t>(status.st_dev), static_cast<std::uintmax_t>(status.st_ino)};
+#else
+   static_cast<void>(file_name);
+   return std::nullopt;
+#endif
+}
+
+void FileWatcher::watch()
+{
+#if defined(__linux__)
+   const auto current = identify(file_name_);
+   if (!current || current == watched_) {
+      return;
+   }
+   if (watch_ >= 0) {
+      // the watch of a removed file is already gone, removing it again only fails
+      ::inotify_rm_watch(inotify_, watch_);
+   }
+   watch_ = ::inotify_add_watch(inotify_, file_name_.c_str(),
+                                IN_MODIFY | IN_MOVE_SELF | IN_DELETE_SELF | IN_ATTRIB | IN_CLOSE_WRITE);
+   watched_ = current;
+#endif
+}
+
+bool FileWatcher::present() const
+{
+   std::error_code error;
+   if (fs::exists(file_name_, error)) {
+      return true;
+   }
+   // a rotated log is renamed first and created again right after
+   std::this_thread::sleep_for(interval_);
+   return fs::exists(file_name_, error);
+}
+
+bool FileWatcher::wait()
+{
+#if defined(__linux__)
+   if (inotify_ >= 0) {
+      pollfd events_ready{inotify_, POLLIN, 0};
+      if (::poll(&events_ready, 1, static_cast<int>(interval_.count())) > 0) {
+         // the events only wake us up, the file itself tells what happened
+         std::array<char, 4096> events{};
+         while (::read(inotify_, events.data(), events.size()) > 0) {
+         }
+      }
+      const bool exists = present();
+      // a file created again under the name is watched instead of the renamed one
+      watch();
+      return exists;
+   }
+#endif
+   if (!changed()) {
+      std::this_thread::sleep_for(interval_);
+   }
+   return present();
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+/**
+ * @brief FileWatcher waits for a file to change
+ *
+ * On Linux the file is watched with inotify, elsewhere or when inotify is not available its size and
+ * modification time are polled. A file that is renamed and created again under its name, like a
+ * rotated log, is watched under its name again.
+ */
+class FileWatcher {
+  public:
+   /**
+    * @brief Device and inode of a file, they tell a file created again under the same name apart
+    *
+    */
+   struct identity {
+      std::uintmax_t device = 0;
+      std::uintmax_t inode = 0;
+      bool operator==(identity const&) const = default;
+   };
+
+   /**
+    * @brief Watch file_name
+    *
+    * @param file_name
+    * @param interval longest time wait blocks, and the polling interval without inotify
+    */
+   explicit FileWatcher(std::string file_name, std::chrono::milliseconds interval = std::chrono::milliseconds{500});
+   ~FileWatcher();
+   FileWatcher(FileWatcher const&) = delete;
+   FileWatcher(FileWatcher&&) = delete;
+   FileWatcher& operator=(FileWatcher const&) = delete;
+   FileWatcher& operator=(FileWatcher&&) = delete;
+
+   /**
+    * @brief Wait until the file is modified or for at most one interval
+    *
+    * A change that happened since the previous wait is reported right away.
+    *
+    * @return false if the file was removed, or renamed and not created again within one interval
+    */
+   [[nodiscard]] bool wait();
+
+   /**
+    * @brief Identify the file that file_name names now
+    *
+    * @return nothing if the file does not exist or files cannot be identified on this platform
+    */
+   [[nodiscard]] static std::optional<identity> identify(std::string const& file_name);
+
+  private:
+   [[nodiscard]] bool changed();
+   [[nodiscard]] bool present() const;
+   void watch();
+
+   std::string file_name_;
+   std::chrono::milliseconds interval_;
+   int inotify_ = -1;
+   int watch_ = -1;                   /// inotify watch of the file named file_name_ when it was watched
+   std::optional<identity> watched_;  /// the file watch_ watches
+   std::uintmax_t size_ = 0;
+   std::filesystem::file_time_type modified_;
+};
@@ -0,0 +1,248 @@
+#include "line_reader.h"
+#include <algorithm>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+LineReader::LineReader(std::string const& file_name, unsigned threads) : compressed_(detect_compression(file_name))
+{
+   if (compressed_ != compression::none) {
+      decompressor_ = std::make_unique<Decompressor>(file_name, compressed_, threads);
+   }
+   else if (!map(file_name)) {
+      stream_.open(file_name, std::ios::binary);
+   }
+}
+
+LineReader::~LineReader()
+{
+   close();
+}
+
+#if !defined(_WIN32)
+bool LineReader::map(std::string const& file_name)
+{
+   const int fd = ::open(file_name.c_str(), O_RDONLY);
+   if (fd < 0) {
+      return false;
+   }
+
+   struct stat info {};
+   if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+      // pipes and devices cannot be mapped, they are streamed
+      ::close(fd);
+      return false;
+   }
+
+   size_ = static_cast<std::size_t>(info.st_size);
+   if (size_ == 0) {
+      ::close(fd);
+      mapped_ = true;
+      return true;
+   }
+
+   void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+   // the mapping keeps its own reference to the file
+   ::close(fd);
+   if (addr == MAP_FAILED) {
+      size_ = 0;
+      return false;
+   }
+   ::madvise(addr, size_, MADV_SEQUENTIAL);
+
+   data_ = static_cast<const char*>(addr);
+   mapped_ = true;
+   return true;
+}
+
+void LineReader::unmap() noexcept
+{
+   if (data_ != nullptr) {
+      // mmap hands out page aligned read only memory, casting constness away is only done to release it
+      ::munmap(const_cast<char*>(data_), size_);
+   }
+}
+#else
+bool LineReader::map(std::string const&)
+{
+   return false;
+}
+
+void LineReader::unmap() noexcept
+{
+}
+#endif
+
+bool LineReader::getline(std::string_view* line)
+{
+   if (decompressor_) {
+      return getline_decompressed(line);
+   }
+   if (!mapped_) {
+      if (!std::getline(stream_, buffer_, '\n')) {
+         return false;
+      }
+      offset_ += buffer_.size() + (stream_.eof() ? 0 : 1);
+      *line = buffer_;
+      return true;
+   }
+
+   if (offset_ >= size_) {
+      return false;
+   }
+
+   const char* begin = data_ + offset_;
+   const std::size_t remaining = size_ - offset_;
+   const auto* end = static_cast<const char*>(std::memchr(begin, '\n', remaining));
+   if (end == nullptr) {
+      // last line without a line terminator
+      *line = std::string_view(begin, remaining);
+      offset_ = size_;
+      return true;
+   }
+
+   *line = std::string_view(begin, static_cast<std::size_t>(end - begin));
+   offset_ += line->size() + 1;
+   return true;
+}
+
+bool LineReader::read_chunk(std::size_t size, chunk* out)
+{
+   out->storage.clear();
+   out->mapped = {};
+   size = std::max<std::size_t>(size, 1);
+   if (decompressor_) {
+      return read_chunk_decompressed(size, out);
+   }
+
+   if (mapped_) {
+      if (offset_ >= size_) {
+         return false;
+      }
+      std::size_t end = std::min(size_, offset_ + size);
+      if (end < size_) {
+         const auto* line_end = static_cast<const char*>(std::memchr(data_ + end - 1, '\n', size_ - end + 1));
+         end = (line_end == nullptr) ? size_ : static_cast<std::size_t>(line_end - data_) + 1;
+      }
+      out->mapped = std::string_view(data_ + offset_, end - offset_);
+      offset_ = end;
+      return true;
+   }
+
+   out->storage.swap(buffer_);
+   buffer_.clear();
+   while (stream_) {
+      const std::size_t filled = out->storage.size();
+      out->storage.resize(filled + size);
+      stream_.read(out->storage.data() + filled, static_cast<std::streamsize>(size));
+      out->storage.resize(filled + static_cast<std::size_t>(stream_.gcount()));
+
+      const auto line_end = out->storage.rfind('\n');
+      if (stream_ && line_end != std::string::npos) {
+         // keep the incomplete last line for the next chunk
+         buffer_.assign(out->storage, line_end + 1);
+         out->storage.resize(line_end + 1);
+         offset_ += out->storage.size();
+         return true;
+      }
+   }
+   offset_ += out->storage.size();
+   return !out->storage.empty();
+}
+
+bool LineReader::seek(std::size_t offset)
+{
+   if (decompressor_) {
+      return seek_decompressed(offset);
+   }
+   if (mapped_) {
+      offset_ = std::min(offset, size_);
+      return offset_ == offset;
+   }
+   buffer_.clear();
+   stream_.clear();
+   if (!stream_.seekg(static_cast<std::streamoff>(offset))) {
+      return false;
+   }
+   offset_ = offset;
+   return true;
+}
+
+bool LineReader::getline_decompressed(std::string_view* line)
+{
+   if (block_offset_ >= block_.size()) {
+      block_offset_ = 0;
+      if (!decompressor_->read(&block_)) {
+         block_.clear();
+         return false;
+      }
+   }
+   // blocks hold whole lines, only the last line of the input may have no line terminator
+   const std::string_view rest = std::string_view(block_).substr(block_offset_);
+   const auto end = rest.find('\n');
+   *line = rest.substr(0, end);
+   const std::size_t consumed = (end == std::string_view::npos) ? rest.size() : end + 1;
+   block_offset_ += consumed;
+   offset_ += consumed;
+   return true;
+}
+
+bool LineReader::read_chunk_decompressed(std::size_t size, chunk* out)
+{
+   // lines left over from seek come first
+   out->storage.assign(block_, std::min(block_offset_, block_.size()));
+   block_.clear();
+   block_offset_ = 0;
+   while (out->storage.size() < size && decompressor_->read(&block_)) {
+      if (out->storage.empty()) {
+         out->storage.swap(block_);
+      }
+      else {
+         out->storage.append(block_);
+      }
+   }
+   block_.clear();
+   offset_ += out->storage.size();
+   return !out->storage.empty();
+}
+
+bool LineReader::seek_decompressed(std::size_t offset)
+{
+   if (offset < offset_) {
+      return false;
+   }
+   for (;;) {
+      const std::size_t available = block_.size() - block_offset_;
+      if (offset - offset_ <= available) {
+         block_offset_ += offset - offset_;
+         offset_ = offset;
+         return true;
+      }
+      offset_ += available;
+      block_offset_ = 0;
+      if (!decompressor_->read(&block_)) {
+         block_.clear();
+         return false;
+      }
+   }
+}
+
+void LineReader::close()
+{
+   decompressor_.reset();
+   block_.clear();
+   block_offset_ = 0;
+   unmap();
+   data_ = nullptr;
+   size_ = 0;
+   offset_ = 0;
+   mapped_ = false;
+   if (stream_.is_open()) {
+      stream_.close();
+   }
+}
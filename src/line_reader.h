@@ -0,0 +1,141 @@
+#pragma once
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "compression.h"
+
+/**
+ * @brief LineReader reads an input file line by line without copying it
+ *
+ * Regular files are memory mapped and every line is handed out as a view into the mapping.
+ * Inputs that cannot be mapped (pipes, devices, platforms without mmap) are streamed through a
+ * single reused buffer instead. Compressed files are decoded by a Decompressor on another thread.
+ *
+ * Lines are split on '\n' exactly like std::getline, the line terminator is not part of the line.
+ * The input is either consumed line by line with getline or in blocks of whole lines with read_chunk,
+ * the two must not be mixed.
+ */
+class LineReader {
+  public:
+   /**
+    * @brief A block of whole lines
+    *
+    * Mapped input is referenced in place, streamed input is owned by the chunk.
+    * The chunk can be moved to another thread and outlives the next read_chunk call.
+    */
+   struct chunk {
+      std::string storage;
+      std::string_view mapped;
+
+      /**
+       * @brief The lines of the chunk including their line terminators
+       *
+       * @return std::string_view
+       */
+      [[nodiscard]] std::string_view lines() const noexcept
+      {
+         return storage.empty() ? mapped : std::string_view(storage);
+      }
+   };
+
+   /**
+    * @brief Open file_name for reading, mapping it into memory when possible
+    *
+    * @param file_name
+    * @param threads number of threads decoding a compressed file
+    * @throws std::runtime_error if the file is compressed in a format this build cannot read
+    */
+   explicit LineReader(std::string const& file_name, unsigned threads = 1);
+   ~LineReader();
+   LineReader(LineReader const&) = delete;
+   LineReader(LineReader&&) = delete;
+   LineReader& operator=(LineReader const&) = delete;
+   LineReader& operator=(LineReader&&) = delete;
+
+   /**
+    * @brief Read the next line
+    *
+    * The view stays valid until the next call to getline or close.
+    *
+    * @param line is set to the next line
+    * @return false when there are no more lines
+    */
+   [[nodiscard]] bool getline(std::string_view* line);
+
+   /**
+    * @brief Read the next block of about size bytes, extended to the end of its last line
+    *
+    * Mapped chunks stay valid until close.
+    *
+    * @param size minimum number of bytes in the chunk unless the input ends
+    * @param out is set to the next chunk
+    * @return false when the input is exhausted
+    */
+   [[nodiscard]] bool read_chunk(std::size_t size, chunk* out);
+
+   /**
+    * @brief Number of input bytes handed out by getline and read_chunk so far, after decompression
+    *
+    * @return std::size_t
+    */
+   [[nodiscard]] std::size_t offset() const noexcept
+   {
+      return offset_;
+   }
+
+   /**
+    * @brief Continue reading at offset, which must be the start of a line
+    *
+    * Compressed input is decoded up to offset, it can only be moved forward.
+    *
+    * @param offset
+    * @return false if the input cannot be repositioned, like a pipe
+    */
+   [[nodiscard]] bool seek(std::size_t offset);
+
+   /**
+    * @brief Release the mapping or the stream
+    *
+    */
+   void close();
+
+   /**
+    * @brief Check if the input is served from a memory mapping
+    *
+    * @return true if the file is memory mapped
+    */
+   [[nodiscard]] bool is_mapped() const noexcept
+   {
+      return mapped_;
+   }
+
+   /**
+    * @brief Get the compression of the input
+    *
+    * @return compression::none if the input is read as it is
+    */
+   [[nodiscard]] compression compressed() const noexcept
+   {
+      return compressed_;
+   }
+
+  private:
+   bool map(std::string const& file_name);
+   void unmap() noexcept;
+   bool getline_decompressed(std::string_view* line);
+   bool read_chunk_decompressed(std::size_t size, chunk* out);
+   bool seek_decompressed(std::size_t offset);
+
+   const char* data_ = nullptr;
+   std::size_t size_ = 0;
+   std::size_t offset_ = 0;  /// read position in the mapping, bytes handed out of the stream
+   bool mapped_ = false;
+   std::ifstream stream_;
+   std::string buffer_;  /// current line, or the incomplete last line of a streamed chunk
+   compression compressed_ = compression::none;
+   std::unique_ptr<Decompressor> decompressor_;
+   std::string block_;             /// decoded lines
+   std::size_t block_offset_ = 0;  /// start of the lines in block_ not handed out yet
+};
@@ -1,11 +1,18 @@
 #include <sys/stat.h>
+#include <atomic>
+#include <charconv>
+#include <csignal>
 #include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <stdexcept>
+#include <string>
 #include <string_view>
+#include <vector>
 #include "LogalizerConfig.h"
+#include "batch.h"
 #include "jsonconfigparser.h"
 #include "spdlog/spdlog.h"
 #include "translator.h"
@@ -22,7 +29,10 @@ void printHelp()
              << "  Helper to visualize and understand logs.\n"
                 "  Logesh Gopalakrishnan\n\n"
                 "Usage:\n"
-                "  logalizer -c <config> -f <log>\n"
+                "  logalizer -c <config> -f <log> [--threads <n>] [--stats <format>] [--follow] [--resume]\n"
+                "            [--compress-trimmed]\n"
+                "  logalizer -c <config> -f <log>... [--files-from <list>] [--jobs <n>] [--threads <n>]\n"
+                "  logalizer -c <config> --compile-config <compiled>\n"
                 "  logalizer -f <log>\n"
                 "  logalizer -h | --help\n"
                 "  logalizer --version\n"
@@ -31,12 +41,35 @@ void printHelp()
                 "  -h --help        Show this screen\n"
                 "  --config-help    Show sample configuration\n"
                 "  --version        Show version\n"
-                "  -c <config>      Translation configuration file. Defaults to config.json\n"
-                "  -f <log>         Log file to be interpreted\n"
+                "  -c <config>      Translation configuration file, JSON or compiled with --compile-config.\n"
+                "                   Defaults to config.json\n"
+                "  -f <log>         Log file to be interpreted. Repeat it or use * and ? in the file name to\n"
+                "                   translate several logs with one configuration\n"
+                "  --files-from <list>\n"
+                "                   Translate the logs listed in the file list, one per line\n"
+                "  --jobs <n>       Translate n logs at once, 0 uses all cores. Defaults to 1\n"
+                "  --compile-config <compiled>\n"
+                "                   Write the loaded configuration to a compiled file and exit. <config>\n"
+                "                   with the extension .lzc is used instead of <config> while it is newer\n"
+                "  --threads <n>    Translate with n threads, 0 uses all cores. Defaults to 1\n"
+                "  --stats <format> Print line counts, stage times and cost per translation as text or json\n"
+                "  --follow         Keep translating lines appended to the log until it is removed or Ctrl+C\n"
+                "  --resume         Continue an interrupted translation of the log from its last checkpoint\n"
+                "  --compress-trimmed\n"
+                "                   Replace a gzip, zstd or lz4 log with its trimmed lines in the same format.\n"
+                "                   By default the log is kept and the trimmed lines go to <log>.trim.log\n"
                 "\n"
                 "Example:\n"
                 "  logalizer -c config.json -f trace.log\n"
                 "  logalizer -f trace.log\n"
+                "  logalizer -f trace.log --threads 8\n"
+                "  logalizer -f trace.log --stats json\n"
+                "  logalizer -f device.log --follow\n"
+                "  logalizer -f trace.log --resume\n"
+                "  logalizer -f trace.log.zst --threads 8\n"
+                "  logalizer -f \"logs/*.log\" --jobs 0\n"
+                "  logalizer --files-from logs.txt --jobs 4\n"
+                "  logalizer -c config.json --compile-config config.lzc\n"
              << std::endl;
 }
 
@@ -53,19 +86,104 @@ struct CMD_Args {
     */
    const std::string config_file;
    /**
-    * @brief Input file that needs to be translated
+    * @brief Input files that need to be translated
     *
     */
-   const std::string log_file;
+   const std::vector<std::string> log_files;
+   /**
+    * @brief Number of input files translated at once, 0 for all cores
+    *
+    */
+   const unsigned jobs;
+   /**
+    * @brief Write the configuration compiled to this file instead of translating
+    *
+    */
+   const std::string compile_config;
+   /**
+    * @brief Number of threads used for translation, 0 for all cores
+    *
+    */
+   const unsigned threads;
+   /**
+    * @brief Format of the stats report, text or json. Empty if no stats are collected
+    *
+    */
+   const std::string stats;
+   /**
+    * @brief Follow the log while it is written to instead of translating it once
+    *
+    */
+   const bool follow;
+   /**
+    * @brief Continue from the checkpoint of an interrupted translation
+    *
+    */
+   const bool resume;
+   /**
+    * @brief Write the trimmed lines of a compressed log back in its compression format
+    *
+    */
+   const bool compress_trimmed;
 };
 
+unsigned parse_count(std::string_view option, std::string_view value)
+{
+   unsigned count = 0;
+   const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), count);
+   if (error != std::errc{} || end != value.data() + value.size()) {
+      std::cerr << option << " : expects a number, got " << value << "\n";
+      exit(1);
+   }
+   return count;
+}
+
 CMD_Args parse_cmd_line(const std::vector<std::string_view>& args)
 {
-   std::string log_file;
+   std::vector<std::string> inputs;
    std::string config_file;
+   unsigned jobs = 1;
+   std::string compile_config;
+   unsigned threads = 1;
+   std::string stats;
+   bool follow = false;
+   bool resume = false;
+   bool compress_trimmed = false;
    for (auto it = cbegin(args), endit = cend(args); it != endit; ++it) {
       if ((*it == "-f" || *it == "--file") && next(it) != endit) {
-         log_file = *(next(it));
+         inputs.emplace_back(*(next(it)));
+      }
+      else if (*it == "--files-from" && next(it) != endit) {
+         const std::string list_file(*(next(it)));
+         if (!read_file_list(list_file, &inputs)) {
+            std::cerr << list_file << " : file list not available\n";
+            exit(1);
+         }
+      }
+      else if (*it == "--compile-config" && next(it) != endit) {
+         compile_config = *(next(it));
+      }
+      else if (*it == "--jobs" && next(it) != endit) {
+         jobs = parse_count(*it, *(next(it)));
+      }
+      else if (*it == "--threads" && next(it) != endit) {
+         threads = parse_count(*it, *(next(it)));
+      }
+      else if (*it == "--stats" && next(it) != endit) {
+         stats = *(next(it));
+         if (stats != "text" && stats != "json") {
+            std::cerr << *it << " : expects text or json, got " << stats << "\n";
+            exit(1);
+         }
+      }
+      else if (*it == "--follow") {
+         follow = true;
+      }
+      else if (*it == "--resume") {
+         resume = true;
+      }
+      else if (*it == "--compress-trimmed") {
+         compress_trimmed = true;
       }
       else if ((*it == "-c" || *it == "--config") && next(it) != endit) {
          config_file = *(next(it));
@@ -79,7 +197,8 @@ CMD_Args parse_cmd_line(const std::vector<std::string_view>& args)
          exit(0);
       }
    }
-   if (log_file.empty()) {
+   const auto log_files = expand_inputs(inputs);
+   if (log_files.empty() && compile_config.empty()) {
       printHelp();
       exit(0);
    }
@@ -94,39 +213,29 @@ CMD_Args parse_cmd_line(const std::vector<std::string_view>& args)
       printHelp();
       exit(1);
    }
-   if (!fs::exists(log_file)) {
-      std::cerr << log_file << " : not available\n";
+   for (auto const& log_file : log_files) {
+      if (!fs::exists(log_file)) {
+         std::cerr << log_file << " : not available\n";
+         exit(1);
+      }
+   }
+   if (!compile_config.empty() && fs::path(config_file).extension() == ".lzc") {
+      std::cerr << "--compile-config : expects a JSON configuration, got " << config_file << "\n";
       exit(1);
    }
-
-   return {config_file, log_file};
-}
-
-void backup_if_not_exists(const std::string& original, const std::string& backup)
-{
-   if (original.empty() || backup.empty()) {
-      return;
+   if (follow && log_files.size() > 1) {
+      std::cerr << "--follow : expects a single log, got " << log_files.size() << "\n";
+      exit(1);
    }
 
-   try {
-      fs::create_directories(fs::path(backup).remove_filename());
-      if (!fs::exists(backup)) {
-         fs::copy_file(original, backup);
-      }
-   }
-   catch (std::exception& e) {
-      std::cerr << "Backup failed : " << e.what();
-   }
+   return {config_file, log_files, jobs, compile_config, threads, stats, follow, resume, compress_trimmed};
 }
 
-path_vars get_path_vars(const std::string& log_file)
+static std::atomic_bool stop_following{false};
+
+void request_stop(int)
 {
-   fs::path log_file_path = log_file;
-   path_vars path_details;
-   path_details.dir = log_file_path.parent_path().string();
-   path_details.file = log_file_path.filename().string();
-   path_details.file_no_ext = fs::path(path_details.file).replace_extension("").string();
-   return path_details;
+   stop_following = true;
 }
 
 static std::chrono::time_point<high_resolution_clock> start_time;
@@ -144,6 +253,30 @@ void end_benchmark(std::string const& print)
    std::cout << '[' << count << "ms] " << print << '\n';
 }
 
+int translate_batch(JsonConfigParser const& config, CMD_Args const& cmd_args)
+{
+   BatchTranslator batch(config);
+   batch.set_jobs(cmd_args.jobs);
+   batch.set_threads(cmd_args.threads);
+   batch.set_resume(cmd_args.resume);
+   batch.set_compress_trimmed(cmd_args.compress_trimmed);
+   if (!cmd_args.stats.empty()) {
+      batch.enable_stats();
+   }
+   start_benchmark();
+   const auto failed = batch.translate(cmd_args.log_files);
+   end_benchmark("Translated " + std::to_string(cmd_args.log_files.size() - failed) + " of " +
+                 std::to_string(cmd_args.log_files.size()) + " logs");
+
+   if (cmd_args.stats == "json") {
+      batch.get_stats().print_json(std::cout, config.get_translations());
+   }
+   else if (cmd_args.stats == "text") {
+      batch.get_stats().print_text(std::cout, config.get_translations());
+   }
+   return failed == 0 ? 0 : 3;
+}
+
 int main(int argc, char** argv)
 {
    const std::vector<std::string_view> args(argv, argv + argc);
@@ -151,10 +284,25 @@ int main(int argc, char** argv)
 
    start_benchmark();
    JsonConfigParser config(cmd_args.config_file);
+   // a compiled configuration given with -c is loaded, next to a JSON one it is used while it is newer
+   const bool given_compiled = fs::path(cmd_args.config_file).extension() == ".lzc";
+   const std::string compiled_file =
+       given_compiled ? cmd_args.config_file : fs::path(cmd_args.config_file).replace_extension(".lzc").string();
    try {
-      config.set_path_variables(get_path_vars(cmd_args.log_file));
-      config.read_config_file();
-      config.load_configurations();
+      if (!cmd_args.log_files.empty()) {
+         config.set_path_variables(get_path_vars(cmd_args.log_files.front()));
+      }
+      if (cmd_args.compile_config.empty() && config.load_compiled(compiled_file)) {
+         std::cout << "configuration loaded from " << compiled_file << '\n';
+      }
+      else if (given_compiled) {
+         throw std::runtime_error(compiled_file +
+                                  " : compiled configuration is damaged, out of date or written by another build\n");
+      }
+      else {
+         config.read_config_file();
+         config.load_configurations();
+      }
    }
    catch (std::exception& e) {
       std::cerr << "Loading configuration failed\n";
@@ -163,13 +311,54 @@ int main(int argc, char** argv)
    }
    end_benchmark("Configuration loaded");
 
-   backup_if_not_exists(cmd_args.log_file, config.get_backup_file());
+   if (!cmd_args.compile_config.empty()) {
+      if (!config.save_compiled(cmd_args.compile_config, config.get_source_files())) {
+         std::cerr << cmd_args.compile_config << " : compiled configuration not written\n";
+         return 2;
+      }
+      std::cout << "compiled configuration written to " << cmd_args.compile_config << '\n';
+      return 0;
+   }
+
+   if (cmd_args.log_files.size() > 1) {
+      return translate_batch(config, cmd_args);
+   }
+   const std::string& log_file = cmd_args.log_files.front();
+   backup_if_not_exists(log_file, config.get_backup_file());
 
    Translator translator(config);
+   translator.set_threads(cmd_args.threads);
+   translator.set_resume(cmd_args.resume);
+   translator.set_compress_trimmed(cmd_args.compress_trimmed);
+   if (!cmd_args.stats.empty()) {
+      translator.enable_stats();
+   }
    start_benchmark();
-   translator.translate_file(cmd_args.log_file);
+   if (cmd_args.follow) {
+      std::signal(SIGINT, request_stop);
+      std::signal(SIGTERM, request_stop);
+      std::cout << "Following " << log_file << ", press Ctrl+C to stop" << std::endl;
+      translator.follow_file(log_file, stop_following);
+   }
+   else {
+      try {
+         translator.translate_file(log_file);
+      }
+      catch (std::exception& e) {
+         std::cerr << "Translation failed\n";
+         std::cerr << e.what() << "\n";
+         exit(3);
+      }
+   }
    end_benchmark("Translation file generated");
 
+   if (cmd_args.stats == "json") {
+      translator.get_stats().print_json(std::cout, config.get_translations());
+   }
+   else if (cmd_args.stats == "text") {
+      translator.get_stats().print_text(std::cout, config.get_translations());
+   }
+
    start_benchmark();
    translator.execute_commands();
    end_benchmark("Executed");
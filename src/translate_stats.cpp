@@ -0,0 +1,101 @@
+#include "translate_stats.h"
+#include <algorithm>
+#include <iomanip>
+#include <numeric>
+#include <ostream>
+#include <nlohmann/json.hpp>
+
+namespace {
+
+double milliseconds(translate_stats::duration time)
+{
+   return std::chrono::duration<double, std::milli>(time).count();
+}
+
+std::vector<std::size_t> by_cost(std::vector<translate_stats::translation_stats> const& translations)
+{
+   std::vector<std::size_t> order(translations.size());
+   std::iota(begin(order), end(order), std::size_t{0});
+   std::stable_sort(begin(order), end(order), [&translations](std::size_t lhs, std::size_t rhs) {
+      return translations[lhs].cost > translations[rhs].cost;
+   });
+   return order;
+}
+
+}  // namespace
+
+void translate_stats::merge(translate_stats const& other)
+{
+   lines_read += other.lines_read;
+   lines_deleted += other.lines_deleted;
+   lines_blacklisted += other.lines_blacklisted;
+   lines_translated += other.lines_translated;
+   bytes_in += other.bytes_in;
+   bytes_out += other.bytes_out;
+   delete_time += other.delete_time;
+   replace_time += other.replace_time;
+   match_time += other.match_time;
+   print_time += other.print_time;
+   output_time += other.output_time;
+   total_time += other.total_time;
+   translations.resize(std::max(translations.size(), other.translations.size()));
+   for (std::size_t i = 0; i < other.translations.size(); ++i) {
+      translations[i].hits += other.translations[i].hits;
+      translations[i].cost += other.translations[i].cost;
+   }
+}
+
+void translate_stats::print_text(std::ostream& out,
+                                 std::vector<Logalizer::Config::translation> const& translations_config) const
+{
+   out << "Lines read        : " << lines_read << '\n'
+       << "Lines deleted     : " << lines_deleted << '\n'
+       << "Lines blacklisted : " << lines_blacklisted << '\n'
+       << "Lines translated  : " << lines_translated << '\n'
+       << "Bytes in          : " << bytes_in << '\n'
+       << "Bytes out         : " << bytes_out << '\n'
+       << std::fixed << std::setprecision(3)
+       << "Delete       [ms] : " << milliseconds(delete_time) << '\n'
+       << "Replace      [ms] : " << milliseconds(replace_time) << '\n'
+       << "Match        [ms] : " << milliseconds(match_time) << '\n'
+       << "Print        [ms] : " << milliseconds(print_time) << '\n'
+       << "Output       [ms] : " << milliseconds(output_time) << '\n'
+       << "Total        [ms] : " << milliseconds(total_time) << '\n';
+
+   out << "Translations by cost\n"
+       << "      hits   cost [ms]  translation\n";
+   for (const auto index : by_cost(translations)) {
+      if (index >= translations_config.size()) {
+         continue;
+      }
+      out << std::setw(10) << translations[index].hits << std::setw(12) << milliseconds(translations[index].cost)
+          << "  " << index << ": " << translations_config[index].print << '\n';
+   }
+   out << std::defaultfloat;
+}
+
+void translate_stats::print_json(std::ostream& out,
+                                 std::vector<Logalizer::Config::translation> const& translations_config) const
+{
+   nlohmann::json report;
+   report["lines"] = {{"read", lines_read},
+                      {"deleted", lines_deleted},
+                      {"blacklisted", lines_blacklisted},
+                      {"translated", lines_translated}};
+   report["bytes"] = {{"in", bytes_in}, {"out", bytes_out}};
+   report["time_ms"] = {{"delete", milliseconds(delete_time)},   {"replace", milliseconds(replace_time)},
+                        {"match", milliseconds(match_time)},     {"print", milliseconds(print_time)},
+                        {"output", milliseconds(output_time)},   {"total", milliseconds(total_time)}};
+   report["translations"] = nlohmann::json::array();
+   for (const auto index : by_cost(translations)) {
+      if (index >= translations_config.size()) {
+         continue;
+      }
+      report["translations"].push_back({{"index", index},
+                                        {"category", translations_config[index].category},
+                                        {"print", translations_config[index].print},
+                                        {"hits", translations[index].hits},
+                                        {"cost_ms", milliseconds(translations[index].cost)}});
+   }
+   out << report.dump(2) << '\n';
+}
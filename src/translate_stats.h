@@ -0,0 +1,98 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+#include "config_types.h"
+
+/**
+ * @brief Counters and stage timers of Translator::translate_file
+ *
+ * Collected only when enabled with Translator::enable_stats, translating without stats does not read any clock.
+ */
+struct translate_stats {
+   using clock = std::chrono::steady_clock;
+   using duration = clock::duration;
+
+   /**
+    * @brief Hits and cost of one configured translation
+    *
+    */
+   struct translation_stats {
+      std::uint64_t hits = 0;  /// lines translated by this translation
+      duration cost{};         /// time spent matching and printing the lines of this translation
+   };
+
+   std::uint64_t lines_read = 0;
+   std::uint64_t lines_deleted = 0;
+   std::uint64_t lines_blacklisted = 0;  /// lines that matched a translation but are blacklisted
+   std::uint64_t lines_translated = 0;
+   std::uint64_t bytes_in = 0;
+   std::uint64_t bytes_out = 0;  /// trimmed log and translation file
+   duration delete_time{};       /// delete_lines
+   duration replace_time{};      /// replace_words
+   duration match_time{};        /// finding the translation of a line and checking the blacklist
+   duration print_time{};        /// capturing variables and filling print
+   duration output_time{};       /// writing the trimmed log, duplicates, pairs and writing translations
+   duration total_time{};
+   std::vector<translation_stats> translations;  /// in configuration order
+
+   /**
+    * @brief Add the counters and timers of other
+    *
+    * @param other
+    */
+   void merge(translate_stats const& other);
+
+   /**
+    * @brief Print a human readable report, translations ordered by cost
+    *
+    * @param out
+    * @param translations configuration the stats were collected with
+    */
+   void print_text(std::ostream& out, std::vector<Logalizer::Config::translation> const& translations) const;
+
+   /**
+    * @brief Print the report as JSON
+    *
+    * @param out
+    * @param translations configuration the stats were collected with
+    */
+   void print_json(std::ostream& out, std::vector<Logalizer::Config::translation> const& translations) const;
+};
+
+/**
+ * @brief Adds the time between laps to a stage of translate_stats, does nothing without stats
+ *
+ */
+class stage_clock {
+  public:
+   explicit stage_clock(translate_stats* stats) : stats_(stats)
+   {
+      if (stats_ != nullptr) {
+         last_ = translate_stats::clock::now();
+      }
+   }
+
+   /**
+    * @brief Add the time since the last lap to stage
+    *
+    * @param stage
+    * @return the time since the last lap, zero without stats
+    */
+   translate_stats::duration lap(translate_stats::duration translate_stats::*stage)
+   {
+      if (stats_ == nullptr) {
+         return {};
+      }
+      const auto now = translate_stats::clock::now();
+      const auto elapsed = now - last_;
+      stats_->*stage += elapsed;
+      last_ = now;
+      return elapsed;
+   }
+
+  private:
+   translate_stats* stats_;
+   translate_stats::clock::time_point last_;
+};
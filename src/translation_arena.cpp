@@ -0,0 +1,49 @@
+#include "translation_arena.h"
+#include <algorithm>
+#include <iterator>
+
+void TranslationArena::push_back(std::string_view text)
+{
+   if (blocks_.empty() || blocks_.back().capacity() - blocks_.back().size() < text.size()) {
+      add_block(text.size());
+   }
+   // appending within the capacity never moves the texts already in the block
+   auto& block = blocks_.back();
+   texts_.push_back({static_cast<std::uint32_t>(first_block_ + blocks_.size() - 1),
+                     static_cast<std::uint32_t>(block.size()), static_cast<std::uint32_t>(text.size())});
+   block.append(text);
+}
+
+void TranslationArena::erase_front(std::size_t count)
+{
+   texts_.erase(begin(texts_), begin(texts_) + static_cast<std::ptrdiff_t>(std::min(count, texts_.size())));
+   if (texts_.empty()) {
+      clear();
+      return;
+   }
+   while (first_block_ < texts_.front().block) {
+      spare_ = std::move(blocks_.front());
+      blocks_.pop_front();
+      ++first_block_;
+   }
+}
+
+void TranslationArena::clear() noexcept
+{
+   texts_.clear();
+   if (blocks_.empty()) {
+      return;
+   }
+   // the block being filled is kept, blocks are numbered from it again
+   blocks_.erase(begin(blocks_), std::prev(end(blocks_)));
+   blocks_.front().clear();
+   first_block_ = 0;
+}
+
+void TranslationArena::add_block(std::size_t size)
+{
+   std::string block = std::move(spare_);
+   block.clear();
+   block.reserve(std::max(size, block_size));
+   blocks_.push_back(std::move(block));
+}
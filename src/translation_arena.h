@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief TranslationArena holds a queue of texts in a few large blocks instead of one string each
+ *
+ * Texts are appended one after the other into blocks of block_size bytes, a longer text gets a block
+ * of its own. Texts are only removed from the front, a block is released once none of its texts is
+ * left. The last released block is kept to be filled again, so a queue that is drained as fast as it
+ * grows does not allocate at all.
+ *
+ * The views returned stay valid until their text is removed.
+ */
+class TranslationArena {
+  public:
+   static constexpr std::size_t block_size = std::size_t{64} << 10U;
+
+   void push_back(std::string_view text);
+   /**
+    * @brief Remove the first count texts
+    *
+    */
+   void erase_front(std::size_t count);
+   /**
+    * @brief Remove all texts and release all blocks but one
+    *
+    */
+   void clear() noexcept;
+
+   [[nodiscard]] std::string_view operator[](std::size_t index) const noexcept
+   {
+      auto const& text = texts_[index];
+      return {blocks_[text.block - first_block_].data() + text.offset, text.size};
+   }
+   [[nodiscard]] std::string_view back() const noexcept
+   {
+      return (*this)[texts_.size() - 1];
+   }
+   [[nodiscard]] std::size_t size() const noexcept
+   {
+      return texts_.size();
+   }
+   [[nodiscard]] bool empty() const noexcept
+   {
+      return texts_.empty();
+   }
+
+  private:
+   struct text_record {
+      std::uint32_t block;   /// number of the block, counted from the first block in use after clear
+      std::uint32_t offset;  /// in the block
+      std::uint32_t size;
+   };
+
+   void add_block(std::size_t size);
+
+   std::deque<text_record> texts_;
+   std::deque<std::string> blocks_;  /// filled up to their size, never beyond their capacity
+   std::uint32_t first_block_ = 0;   /// number of blocks_.front()
+   std::string spare_;               /// released block that is reused by add_block
+};
@@ -1,20 +1,53 @@
 #include "translator.h"
 #include <algorithm>
+#include <array>
+#include <charconv>
+#include <deque>
 #include <filesystem>
 #include <fstream>
 #include <functional>
+#include <future>
 #include <iostream>
 #include <list>
 #include <numeric>
+#include <optional>
 #include <ranges>
 #include <regex>
+#include <thread>
+#include <utility>
+#include "async_write_buffer.h"
+#include "checkpoint.h"
+#include "compression.h"
 #include "config_types.h"
+#include "file_watcher.h"
+#include "line_reader.h"
 #include "spdlog/spdlog.h"
 
 namespace fs = std::filesystem;
 using namespace Logalizer::Config;
 namespace rgs = std::ranges;
 
+namespace {
+/**
+ * @brief Open file_name for writing behind its first size bytes, anything after them is cut off
+ *
+ */
+void open_at(std::ofstream& file, std::string const& file_name, std::uintmax_t size)
+{
+   fs::resize_file(file_name, size);
+   file.open(file_name, std::ios::in | std::ios::out);
+   file.seekp(static_cast<std::streamoff>(size));
+}
+
+using count_digits = std::array<char, std::numeric_limits<std::size_t>::digits10 + 1>;
+
+std::string_view format_count(std::size_t count, count_digits* digits)
+{
+   const auto digits_end = std::to_chars(digits->data(), digits->data() + digits->size(), count).ptr;
+   return {digits->data(), static_cast<std::size_t>(digits_end - digits->data())};
+}
+}  // namespace
+
 #if 0
 std::string Translator::fetch_values_regex(std::string const& line, std::vector<variable> const& variables)
 {
@@ -77,305 +110,1020 @@ std::string Translator::fetch_values_braced(std::string const& line, std::vector
 }
 #endif
 
-std::string Translator::capture_values(variable const& var, std::string const& content)
+std::string_view Translator::capture_values(variable_search const& var, std::string_view content) noexcept
 {
-   auto start_point = content.find(var.startswith);
-   if (start_point == std::string::npos) {
+   auto start_point = var.startswith.find(content);
+   if (start_point == std::string_view::npos) {
       return " ";
    }
 
-   start_point += var.startswith.size();
-   const auto end_point = content.find(var.endswith, start_point);
-   if (end_point == std::string::npos || var.endswith.empty()) {
+   start_point += var.startswith.needle().size();
+   const auto end_point = var.endswith.find(content, start_point);
+   if (end_point == std::string_view::npos || var.endswith.needle().empty()) {
       // if endswith is not matching or empty, capture till the end
-      std::string capture(content.cbegin() + static_cast<long>(start_point), content.cend());
-      return capture;
-   }
-
-   std::string capture(content.cbegin() + static_cast<long>(start_point),
-                       content.cbegin() + static_cast<long>(end_point));
-
-   return capture;
-}
-
-std::vector<std::string> Translator::variable_values(std::string const& line, std::vector<variable> const& variables)
-{
-   std::vector<std::string> value;
-   if (variables.empty()) {
-      return {};
+      return content.substr(start_point);
    }
 
-   rgs::transform(variables, std::back_inserter(value),
-                  [&line, this](auto const& var) { return capture_values(var, line); });
-
-   return value;
+   return content.substr(start_point, end_point - start_point);
 }
 
-std::string Translator::pack_parameters(std::vector<std::string> const& v)
+std::vector<std::string_view> const& Translator::variable_values(std::string_view line,
+                                                                 std::vector<variable_search> const& variables)
 {
-   auto comma_fold = [](const std::string& a, const std::string& b) { return a + ", " + b; };
-   const std::string initial_value = "(" + v[0];
-   std::string params = std::accumulate(next(cbegin(v)), cend(v), initial_value, comma_fold) + ")";
-   return params;
+   // the values are only used until the line is printed, they are not copied out of it
+   value_slots_.clear();
+   rgs::transform(variables, std::back_inserter(value_slots_),
+                  [&line](auto const& var) { return capture_values(var, line); });
+   return value_slots_;
 }
 
-std::string Translator::fill_values_formatted(std::vector<std::string> const& values, std::string const& line_to_fill)
+std::string_view Translator::fill_values_formatted(std::vector<std::string_view> const& values, translation const& tr)
 {
-   std::string filled_line = line_to_fill;
-   for (size_t i = 1, len = values.size(); i <= len; ++i) {
-      const std::string token = "\\$\\{" + std::to_string(i) + "\\}";
-      filled_line = std::regex_replace(filled_line, std::regex(token), values[i - 1]);
-   }
-   return filled_line;
-}
-
-std::string Translator::update_variables(std::vector<std::string> const& values, std::string const& line_to_fill)
-{
-   std::string filled_line;
-   if (values.empty()) {
-      filled_line = line_to_fill;
-   }
-   else {
-      const bool formatted_print = (line_to_fill.find("${1}") != std::string::npos);
-      if (formatted_print) {
-         filled_line = fill_values_formatted(values, line_to_fill);
+   print_buffer_.clear();
+   for (auto const& segment : tr.print_format) {
+      if (segment.variable == print_segment::no_variable) {
+         print_buffer_ += segment.text;
       }
       else {
-         filled_line = line_to_fill + pack_parameters(values);
+         print_buffer_ += values[segment.variable];
       }
    }
-   return filled_line;
+   return print_buffer_;
 }
 
-[[nodiscard]] bool Translator::is_blacklisted(std::string const& line)
+[[nodiscard]] bool Translator::is_blacklisted(std::string_view line)
 {
-   return rgs::any_of(config_.get_blacklists(), [&line](auto const& bl) { return line.find(bl) != std::string::npos; });
+   return config_.get_line_filter().find(line, LineFilter::blacklisted) != 0;
 }
 
-auto Translator::get_matching_translator(std::string const& line)
+std::vector<translation>::const_iterator Translator::get_matching_translator(std::string_view line)
 {
-   auto matcher = [&line](auto const& tr) { return tr.in(line); };
    const std::vector<translation>& trcfg = config_.get_translations();
-   auto found = rgs::find_if(trcfg, matcher);
-   // auto found = rgs::find_if(trcfg, std::bind(std::mem_fn(&translation::in), std::placeholders::_1, line));
-   if (found != cend(trcfg)) {
-      if (!is_blacklisted(line)) {
-         return found;
+   // same result as the first translation for which translation::in is true
+   const std::size_t index = config_.get_translation_matcher().find(line, match_scratch_);
+   // trim already scanned an unchanged line for blacklist entries
+   const bool blacklist_known = std::exchange(blacklist_known_, false);
+   if (index < trcfg.size()) {
+      if (!(blacklist_known ? line_blacklisted_ : is_blacklisted(line))) {
+         return cbegin(trcfg) + static_cast<std::ptrdiff_t>(index);
+      }
+      if (stats() != nullptr) {
+         ++stats_.lines_blacklisted;
       }
    }
    return cend(trcfg);
 }
 
-[[nodiscard]] bool Translator::is_deleted(std::string const& line) noexcept
+[[nodiscard]] bool Translator::is_deleted(std::string_view line) noexcept
 {
-   bool deleted =
-       rgs::any_of(config_.get_delete_lines(), [&line](auto const& dl) { return line.find(dl) != std::string::npos; });
+   return config_.get_line_filter().find(line, LineFilter::deleted) != 0 || matches_delete_regex(line);
+}
 
-   if (deleted) {
-      return true;
-   }
+[[nodiscard]] bool Translator::matches_delete_regex(std::string_view line) noexcept
+{
+   return rgs::any_of(config_.get_delete_lines_linear(), [&line](auto const& dl) { return dl.search(line); }) ||
+          rgs::any_of(config_.get_delete_lines_regex(),
+                      [&line](auto const& dl) { return std::regex_search(line.begin(), line.end(), dl); });
+}
 
-   deleted = rgs::any_of(config_.get_delete_lines_regex(), [&line](auto const& dl) { return regex_search(line, dl); });
+void Translator::replace_all(std::string* line, replacement const& entry)
+{
+   auto found = entry.search_literal.find(*line);
+   if (found == std::string::npos) {
+      return;
+   }
 
-   return deleted;
+   replace_buffer_.clear();
+   std::size_t from = 0;
+   for (; found != std::string::npos; found = entry.search_literal.find(*line, from)) {
+      replace_buffer_.append(*line, from, found - from);
+      replace_buffer_.append(entry.replace);
+      from = found + entry.search.size();
+   }
+   replace_buffer_.append(*line, from);
+   line->swap(replace_buffer_);
 }
 
 void Translator::replace_words(std::string* line)
 {
-   auto regex_replace = [&](auto const& entry) {
-      *line = std::regex_replace(*line, std::regex(entry.search), entry.replace);
+   auto replace = [&](auto const& entry) {
+      if (entry.literal) {
+         replace_all(line, entry);
+      }
+      else {
+         *line = std::regex_replace(*line, entry.search_regex, entry.replace);
+      }
    };
-   rgs::for_each(config_.get_replace_words(), regex_replace);
+   rgs::for_each(config_.get_replace_words(), replace);
 }
 
-void Translator::add_translation(std::string&& translation, duplicates_t duplicates)
+std::size_t Translator::find_first(std::string_view translation) const
 {
-   auto contains = [this](const auto& str) { return std::find(cbegin(translations), cend(translations), str); };
+   const auto first = first_index_.find(translation);
+   return (first == cend(first_index_)) ? std::string::npos : first->second;
+}
 
+void Translator::append_translation(std::string_view translation)
+{
+   if (index_translations_ && first_index_.find(translation) == cend(first_index_)) {
+      first_index_.emplace(translation, flushed_ + translations.size());
+   }
+   if (counts_open_ && first_open_ == std::string::npos &&
+       translation.find(count_placeholder) != std::string_view::npos) {
+      // any translation with a ${count} may still be counted by a count duplicate, whatever added it
+      first_open_ = flushed_ + translations.size();
+   }
+   translations.push_back(translation);
+   trans_count.emplace_back();
+}
+
+void Translator::add_translation(std::string_view translation, duplicates_t duplicates)
+{
    spdlog::debug("Adding translation {}", translation);
 
    switch (duplicates) {
       case duplicates_t::allowed: {
-         translations.emplace_back(std::move(translation));
+         append_translation(translation);
          break;
       }
       case duplicates_t::remove: {
-         if (contains(translation) == translations.cend()) {
-            translations.emplace_back(std::move(translation));
+         if (find_first(translation) == std::string::npos) {
+            append_translation(translation);
          }
          break;
       }
       case duplicates_t::remove_continuous: {
          if (translations.empty() || translation != translations.back()) {
-            translations.emplace_back(std::move(translation));
+            append_translation(translation);
          }
          break;
       }
       case duplicates_t::count: {
-         auto first = contains(translation);
-         if (translations.empty() || first == translations.cend()) {
-            translations.emplace_back(std::move(translation));
-            trans_count[translations.size() - 1]++;
+         const std::size_t first = find_first(translation);
+         if (first == std::string::npos) {
+            append_translation(translation);
+            add_count(flushed_ + translations.size() - 1, translation);
          }
-         else {
-            trans_count[static_cast<size_t>(std::distance(cbegin(translations), first))]++;
+         else if (first >= flushed_) {
+            // translations with a ${count} are held back, a written one had no ${count} to update
+            add_count(first, translation);
          }
          break;
       }
       case duplicates_t::count_continuous: {
          if (translations.empty() || translation != translations.back()) {
-            translations.emplace_back(std::move(translation));
+            append_translation(translation);
          }
-         trans_count[translations.size() - 1]++;
+         add_count(flushed_ + translations.size() - 1, translation);
          break;
       }
    }
+
+   if (translations.size() >= flush_at_) {
+      flush_translations(false);
+   }
+}
+
+Translator::count_entry& Translator::add_count(std::size_t index, std::string_view translation)
+{
+   auto& counted = trans_count[index - flushed_];
+   if (counted.count == 0) {
+      // the placeholder is found once, the final count is spliced in when the translation is written
+      counted.placeholder = translation.find(count_placeholder);
+   }
+   ++counted.count;
+   if (index >= rendered_first_ && index - rendered_first_ < rendered_.size() &&
+       counted.placeholder != std::string_view::npos) {
+      // the count shown in the followed translation file is updated by the next render_pending
+      auto& shown = rendered_[index - rendered_first_];
+      if (!shown.recounted) {
+         shown.recounted = true;
+         recounted_.push_back(index);
+      }
+   }
+   return counted;
 }
 
-void Translator::update_count()
+std::string_view Translator::apply_count(std::size_t index, std::string_view translation)
 {
-   for (auto const& [index, count] : trans_count) {
-      translations[index] =
-          std::regex_replace(translations[index], std::regex(R"(\$\{count\})"), std::to_string(count));
+   auto const& counted = trans_count[index - flushed_];
+   if (counted.count == 0 || counted.placeholder == std::string_view::npos) {
+      return translation;
+   }
+   count_digits digits{};
+   const std::string_view count = format_count(counted.count, &digits);
+
+   count_buffer_.clear();
+   std::size_t copied = 0;
+   for (auto at = counted.placeholder; at != std::string_view::npos; at = translation.find(count_placeholder, copied)) {
+      count_buffer_.append(translation.substr(copied, at - copied)).append(count);
+      copied = at + count_placeholder.size();
    }
+   count_buffer_.append(translation.substr(copied));
+   return count_buffer_;
 }
 
 void Translator::add_pre_text()
 {
-   rgs::copy(config_.get_wrap_text_pre(), std::back_inserter(translations));
+   for (auto const& text : config_.get_wrap_text_pre()) {
+      append_translation(text);
+   }
 }
 
 void Translator::add_post_text()
 {
-   rgs::copy(config_.get_wrap_text_post(), std::back_inserter(translations));
+   for (auto const& text : config_.get_wrap_text_post()) {
+      write_translation(text);
+   }
 }
 
-void Translator::write_translation_file()
+void Translator::open_translation_file(std::uintmax_t resume_at)
 {
    std::string const& tr_file_name = config_.get_translation_file();
    fs::create_directories(fs::path(tr_file_name).remove_filename());
-   std::ofstream translation_file(tr_file_name);
-   if (config_.get_auto_new_line()) {
-      rgs::copy(translations, std::ostream_iterator<std::string>(translation_file, "\n"));
+   if (resume_at == 0) {
+      translation_file_.open(tr_file_name);
    }
    else {
-      rgs::copy(translations, std::ostream_iterator<std::string>(translation_file));
+      open_at(translation_file_, tr_file_name, resume_at);
    }
-   translation_file.close();
+
+   auto uses = [this](duplicates_t duplicates) {
+      return rgs::any_of(config_.get_translations(),
+                         [duplicates](auto const& tr) { return tr.duplicates == duplicates; });
+   };
+   index_translations_ = uses(duplicates_t::remove) || uses(duplicates_t::count);
+   counts_open_ = uses(duplicates_t::count);
+   pair_open_.assign(config_.get_pairs().size(), false);
 }
 
-void Translator::write_to_file(std::string const& line, std::ofstream& trimmed_file)
+void Translator::write_translation(std::string_view translation)
 {
-   trimmed_file << line << '\n';
+   if (stats() != nullptr) {
+      stats_.bytes_out += translation.size() + (config_.get_auto_new_line() ? 1 : 0);
+   }
+   translation_file_.write(translation.data(), static_cast<std::streamsize>(translation.size()));
+   if (config_.get_auto_new_line()) {
+      translation_file_.put('\n');
+   }
 }
 
-std::string Translator::fill_values(std::string const& line, Logalizer::Config::translation const& tr)
+void Translator::flush_translations(bool finished)
 {
-   std::string updated_print;
-   auto values = variable_values(line, tr.variables);
-   updated_print = update_variables(values, tr.print);
-   return updated_print;
-   // std::string translation = update_variables(variable_values(line, trcfg->variables), trcfg->print);
-   // std::string translation = line
-   //    | variable_values(trcfg->variables)
-   //    | update_variables(trcfg->print);
-   // flow(
-   //    variable_values(trcfg->variables),
-   //    update_variables(trcfg->print)
-   // )(line);
+   std::size_t final_end = translations.size();
+   if (!finished) {
+      // The last translation is kept for continuous duplicates. With count duplicates a ${count}
+      // may be incremented by any later line, it is held back together with everything after it.
+      final_end = translations.empty() ? final_end : final_end - 1;
+      if (first_open_ != std::string::npos) {
+         final_end = std::min(final_end, first_open_ - flushed_);
+      }
+   }
+
+   const auto& pairs = config_.get_pairs();
+   std::vector<std::size_t> errors;
+   for (std::size_t index = 0; index < final_end; ++index) {
+      const std::string_view translation = apply_count(flushed_ + index, translations[index]);
+      if (!pairs.empty()) {
+         // errors are written before the translation they were found at
+         errors.clear();
+         check_pairs(translation, &errors);
+         for (const auto error : errors) {
+            write_translation(pairs[error].error);
+         }
+      }
+      write_translation(translation);
+   }
+
+   flushed_ += final_end;
+   translations.erase_front(final_end);
+   trans_count.erase(begin(trans_count), begin(trans_count) + static_cast<std::ptrdiff_t>(final_end));
+   if (finished) {
+      first_open_ = std::string::npos;
+   }
+   flush_at_ = std::max(flush_batch, 2 * translations.size());
+}
+
+void Translator::write_translation_file()
+{
+   flush_translations(true);
+
+   // case 4: Source is found and pairswith is not found till EOF
+   const auto& pairs = config_.get_pairs();
+   for (std::size_t index = 0; index < pairs.size(); ++index) {
+      if (pair_open_[index]) {
+         write_translation(pairs[index].error);
+      }
+   }
+
+   add_post_text();
+   translation_file_.close();
+   translations.clear();
+   trans_count.clear();
+   first_open_ = std::string::npos;
+   first_index_.clear();
+   flushed_ = 0;
+   flush_at_ = flush_batch;
+}
+
+bool Translator::changes_input() const noexcept
+{
+   return !config_.get_delete_lines().empty() || !config_.get_delete_lines_linear().empty() ||
+          !config_.get_delete_lines_regex().empty() || !config_.get_replace_words().empty();
+}
+
+void Translator::write_to_file(std::string_view line, std::ostream& trimmed_file)
+{
+   if (stats() != nullptr) {
+      stats_.bytes_out += line.size() + 1;
+   }
+   if (!join_trimmed_) {
+      trimmed_file.write(line.data(), static_cast<std::streamsize>(line.size()));
+      trimmed_file.put('\n');
+      return;
+   }
+   // Only a deleted line or a stripped '\r' ends a run of kept lines, the rest of the input is
+   // written in as few pieces as there are gaps
+   if (trimmed_run_.data() != nullptr && line.data() == trimmed_run_.data() + trimmed_run_.size() + 1) {
+      trimmed_run_ = std::string_view(trimmed_run_.data(), trimmed_run_.size() + 1 + line.size());
+      return;
+   }
+   write_trimmed_run(trimmed_file);
+   trimmed_run_ = line;
+}
+
+void Translator::write_trimmed_run(std::ostream& trimmed_file)
+{
+   if (trimmed_run_.data() == nullptr) {
+      return;
+   }
+   trimmed_file.write(trimmed_run_.data(), static_cast<std::streamsize>(trimmed_run_.size()));
+   trimmed_file.put('\n');
+   trimmed_run_ = {};
+}
+
+std::string_view Translator::fill_values(std::string_view line, Logalizer::Config::translation const& tr)
+{
+   return fill_values_formatted(variable_values(line, tr.variable_searches), tr);
+}
+
+bool Translator::trim(std::string_view* line)
+{
+   stage_clock clock(stats());
+   if (stats() != nullptr) {
+      ++stats_.lines_read;
+      stats_.bytes_in += line->size() + 1;
+   }
+   if (!line->empty() && line->back() == '\r') line->remove_suffix(1);
+   // a line that is not rewritten is checked against delete_lines and blacklist in one scan
+   const bool rewritten = !config_.get_replace_words().empty();
+   const unsigned lists = config_.get_line_filter().find(
+       *line, rewritten ? LineFilter::deleted : LineFilter::deleted | LineFilter::blacklisted);
+   blacklist_known_ = false;
+   const bool deleted = (lists & LineFilter::deleted) != 0 || matches_delete_regex(*line);
+   clock.lap(&translate_stats::delete_time);
+   if (deleted) {
+      if (stats() != nullptr) {
+         ++stats_.lines_deleted;
+      }
+      return false;
+   }
+   blacklist_known_ = !rewritten;
+   line_blacklisted_ = (lists & LineFilter::blacklisted) != 0;
+   if (rewritten) {
+      // only lines that get rewritten are copied out of the input
+      replaced_line_.assign(*line);
+      replace_words(&replaced_line_);
+      *line = replaced_line_;
+      clock.lap(&translate_stats::replace_time);
+   }
+   return true;
+}
+
+void Translator::count_translation(std::vector<translation>::const_iterator trcfg, translate_stats::duration cost)
+{
+   if (stats() == nullptr) {
+      return;
+   }
+   auto& translation_stats = stats_.translations[static_cast<std::size_t>(trcfg - cbegin(config_.get_translations()))];
+   ++stats_.lines_translated;
+   ++translation_stats.hits;
+   translation_stats.cost += cost;
 }
 
-void Translator::translate(std::string const& line)
+void Translator::translate(std::string_view line)
 {
+   stage_clock clock(stats());
    const auto& trcfg = get_matching_translator(line);
+   const auto match_time = clock.lap(&translate_stats::match_time);
    if (trcfg == cend(config_.get_translations())) {
       return;
    }
    const auto& tr = *trcfg;
-   std::string translation = fill_values(line, tr);
-   add_translation(std::move(translation), trcfg->duplicates);
+   const std::string_view translation = fill_values(line, tr);
+   count_translation(trcfg, match_time + clock.lap(&translate_stats::print_time));
+   add_translation(translation, trcfg->duplicates);
+   clock.lap(&translate_stats::output_time);
+}
+
+Translator::translated_chunk Translator::translate_chunk(std::string_view lines)
+{
+   translated_chunk chunk;
+   chunk.trimmed.reserve(lines.size());
+   while (!lines.empty()) {
+      const auto line_end = lines.find('\n');
+      std::string_view line = lines.substr(0, line_end);
+      lines.remove_prefix(line_end == std::string_view::npos ? lines.size() : line_end + 1);
+      if (!trim(&line)) {
+         continue;
+      }
+      if (write_trimmed_) {
+         chunk.trimmed.append(line).push_back('\n');
+      }
+
+      stage_clock clock(stats());
+      const auto& trcfg = get_matching_translator(line);
+      const auto match_time = clock.lap(&translate_stats::match_time);
+      if (trcfg != cend(config_.get_translations())) {
+         chunk.translations.emplace_back(std::string(fill_values(line, *trcfg)), trcfg->duplicates);
+         count_translation(trcfg, match_time + clock.lap(&translate_stats::print_time));
+      }
+   }
+   if (stats() != nullptr) {
+      chunk.stats = stats_;
+   }
+   return chunk;
 }
 
-bool Translator::matches_pattern(std::string const& line, std::vector<std::string>& patterns) const
+void Translator::merge_chunk(translated_chunk&& chunk, std::ostream& trimmed_file)
 {
-   auto matches = [&line](auto const& pattern) { return static_cast<bool>(line.find(pattern) != std::string::npos); };
-   return std::all_of(cbegin(patterns), cend(patterns), matches);
+   stage_clock clock(stats());
+   if (stats() != nullptr) {
+      stats_.merge(chunk.stats);
+      stats_.bytes_out += chunk.trimmed.size();
+   }
+   trimmed_file.write(chunk.trimmed.data(), static_cast<std::streamsize>(chunk.trimmed.size()));
+   for (auto& [translation, duplicates] : chunk.translations) {
+      add_translation(translation, duplicates);
+   }
+   clock.lap(&translate_stats::output_time);
 }
 
-bool Translator::matches_pattern(std::string const& line, std::string& pattern) const
+void Translator::translate_lines(LineReader& trace_file, std::ostream& trimmed_file)
 {
-   return static_cast<bool>(line.find(pattern) != std::string::npos);
+   for (std::string_view line; trace_file.getline(&line); checkpoint(trace_file.offset(), trimmed_file)) {
+      if (!trim(&line)) {
+         continue;
+      }
+      if (write_trimmed_) {
+         stage_clock clock(stats());
+         write_to_file(line, trimmed_file);
+         clock.lap(&translate_stats::output_time);
+      }
+      translate(line);
+   }
+   write_trimmed_run(trimmed_file);
+}
+
+void Translator::translate_chunks(LineReader& trace_file, std::ostream& trimmed_file)
+{
+   // Chunks are translated by independent workers, duplicates and counts are handled in input order
+   // while merging. At most threads_ chunks are in flight.
+   std::deque<std::pair<std::future<translated_chunk>, std::uintmax_t>> in_flight;  /// with their input end
+   auto merge_oldest = [&]() {
+      merge_chunk(in_flight.front().first.get(), trimmed_file);
+      checkpoint(in_flight.front().second, trimmed_file);
+      in_flight.pop_front();
+   };
+
+   for (LineReader::chunk chunk; trace_file.read_chunk(chunk_size_, &chunk);) {
+      if (in_flight.size() >= threads_) {
+         merge_oldest();
+      }
+      auto translated = std::async(std::launch::async, [this, lines = std::move(chunk)]() {
+         Translator worker(config_);
+         worker.write_trimmed_ = write_trimmed_;
+         if (stats() != nullptr) {
+            worker.enable_stats();
+         }
+         return worker.translate_chunk(lines.lines());
+      });
+      in_flight.emplace_back(std::move(translated), trace_file.offset());
+   }
+   while (!in_flight.empty()) {
+      merge_oldest();
+   }
 }
 
-void Translator::validate_pairs()
+void Translator::check_pairs(std::string_view line, std::vector<std::size_t>* errors)
 {
-   std::vector<std::pair<int, std::string>> insertions;
-   for (const auto& pair : config_.get_pairs()) {
-      size_t source = INT32_MAX;
-      size_t pairswith = INT32_MAX;
-      size_t before = INT32_MAX;
-      for (size_t i = 0; i < translations.size(); ++i) {
-         const std::string& line = translations[i];
+   config_.get_pair_matcher().find(line, pair_scratch_);
+   // same decisions as checking every pair on its own
+   for (const auto index : pair_scratch_.found) {
+      const auto roles = pair_scratch_.roles[index];
+      const bool open = pair_open_[index];
+      if (roles & PairMatcher::source) {
          // case 5: Source is already found and source is found again
-         if (source != INT32_MAX && line.find(pair.source) != std::string::npos) {
-            insertions.push_back({i, pair.error});
-            source = i;
-            continue;
+         if (open) {
+            errors->push_back(index);
          }
          // case 1: Source is found
-         else if (line.find(pair.source) != std::string::npos) {
-            source = i;
-            continue;
-         }
-         // case 2: Source is found, matching pair is found
-         else if (source != INT32_MAX && line.find(pair.pairswith) != std::string::npos) {
-            source = pairswith = INT32_MAX;
-            continue;
-         }
-         // case 3: Source is found, before is found before a matching pair is found
-         else if (source != INT32_MAX && line.find(pair.before) != std::string::npos) {
-            insertions.push_back({i, pair.error});
-            source = before = INT32_MAX;
-         }
+         pair_open_[index] = true;
+      }
+      // case 2: Source is found, matching pair is found
+      else if (open && (roles & PairMatcher::pairswith)) {
+         pair_open_[index] = false;
       }
-      // case 4: Source is found and pairswith is not found till EOF
-      if (source != INT32_MAX && pairswith == INT32_MAX && before == INT32_MAX) {
-         translations.push_back(pair.error);
+      // case 3: Source is found, before is found before a matching pair is found
+      else if (open && (roles & PairMatcher::before)) {
+         errors->push_back(index);
+         pair_open_[index] = false;
       }
    }
-   // Insert all the errors
-   for (const auto& item : insertions) {
-      translations.insert(translations.begin() + item.first, item.second);
+}
+
+void Translator::checkpoint(std::uintmax_t input_offset, std::ostream& trimmed_file)
+{
+   if (input_offset >= next_checkpoint_) {
+      save_checkpoint(input_offset, trimmed_file);
+      next_checkpoint_ = input_offset + checkpoint_interval_;
+   }
+}
+
+void Translator::save_checkpoint(std::uintmax_t input_offset, std::ostream& trimmed_file)
+{
+   // the outputs are on storage before a checkpoint refers to them
+   write_trimmed_run(trimmed_file);
+   trimmed_file.flush();
+   translation_file_.flush();
+   if ((write_trimmed_ && !sync_file(trim_file_name_)) || !sync_file(config_.get_translation_file())) {
+      spdlog::warn("Checkpoint skipped, outputs could not be synced");
+      return;
+   }
+
+   CheckpointWriter saved(checkpoint_file_);
+   saved.put(input_size_);
+   saved.put(static_cast<std::uint64_t>(input_time_));
+   saved.put(config_.get_translations().size());
+   saved.put(input_offset);
+   saved.put(write_trimmed_ ? static_cast<std::uintmax_t>(trimmed_file.tellp()) : std::uintmax_t{0});
+   saved.put(static_cast<std::uintmax_t>(translation_file_.tellp()));
+   saved.put(flushed_);
+   saved.put(pair_open_.size());
+   for (const bool open : pair_open_) {
+      saved.put(open ? 1U : 0U);
+   }
+   saved.put(translations.size());
+   for (std::size_t index = 0; index < translations.size(); ++index) {
+      saved.put(translations[index]);
+   }
+   // only counted translations are saved, with their number
+   const auto counted = rgs::count_if(trans_count, [](auto const& entry) { return entry.count != 0; });
+   saved.put(static_cast<std::size_t>(counted));
+   for (std::size_t index = 0; index < trans_count.size(); ++index) {
+      if (trans_count[index].count != 0) {
+         saved.put(flushed_ + index);
+         saved.put(trans_count[index].count);
+      }
+   }
+   saved.put(first_index_.size());
+   for (auto const& [translation, index] : first_index_) {
+      saved.put(translation);
+      saved.put(index);
+   }
+   if (!saved.commit()) {
+      spdlog::warn("Checkpoint {} could not be written", checkpoint_file_);
+   }
+}
+
+bool Translator::resume_from_checkpoint(LineReader& trace_file, std::ofstream& trimmed_file)
+{
+   CheckpointReader saved(checkpoint_file_);
+   std::uint64_t input_size = 0;
+   std::uint64_t input_time = 0;
+   std::uint64_t translation_count = 0;
+   std::uint64_t input_offset = 0;
+   std::uint64_t trimmed_size = 0;
+   std::uint64_t translated_size = 0;
+   std::uint64_t flushed = 0;
+   std::uint64_t pair_count = 0;
+   if (!saved.get(&input_size) || !saved.get(&input_time) || !saved.get(&translation_count) ||
+       !saved.get(&input_offset) || !saved.get(&trimmed_size) || !saved.get(&translated_size) ||
+       !saved.get(&flushed) || !saved.get(&pair_count)) {
+      spdlog::warn("No checkpoint to resume from, translating from the start");
+      return false;
+   }
+
+   std::error_code error;
+   std::string const& tr_file_name = config_.get_translation_file();
+   if (input_size != input_size_ || static_cast<std::int64_t>(input_time) != input_time_ ||
+       translation_count != config_.get_translations().size() || pair_count != config_.get_pairs().size() ||
+       (write_trimmed_ && (fs::file_size(trim_file_name_, error) < trimmed_size || error)) ||
+       fs::file_size(tr_file_name, error) < translated_size || error) {
+      spdlog::warn("Checkpoint does not match the input or the configuration, translating from the start");
+      return false;
+   }
+
+   // the state is only replaced once the whole checkpoint is read
+   std::vector<bool> pair_open(static_cast<std::size_t>(pair_count));
+   TranslationArena pending;
+   std::deque<count_entry> counts;
+   std::unordered_map<std::string, size_t, text_hash, std::equal_to<>> first_index;
+   std::uint64_t size = 0;
+   std::uint64_t number = 0;
+   std::uint64_t count = 0;
+   std::string text;
+   bool complete = true;
+   for (std::size_t index = 0; complete && index < pair_open.size(); ++index) {
+      complete = saved.get(&number);
+      pair_open[index] = number != 0;
+   }
+   complete = complete && saved.get(&size);
+   for (std::uint64_t index = 0; complete && index < size; ++index) {
+      complete = saved.get(&text);
+      pending.push_back(text);
+   }
+   counts.resize(pending.size());
+   complete = complete && saved.get(&size);
+   for (std::uint64_t index = 0; complete && index < size; ++index) {
+      complete = saved.get(&number) && saved.get(&count) && number >= flushed && number - flushed < pending.size();
+      if (complete) {
+         // the placeholders were not saved, they are found again in the translations
+         const auto pending_index = static_cast<std::size_t>(number - flushed);
+         counts[pending_index] = {count, pending[pending_index].find(count_placeholder)};
+      }
+   }
+   complete = complete && saved.get(&size);
+   for (std::uint64_t index = 0; complete && index < size; ++index) {
+      complete = saved.get(&text) && saved.get(&number);
+      first_index.emplace(std::move(text), number);
+   }
+   if (!complete || !trace_file.seek(input_offset)) {
+      spdlog::warn("Checkpoint cannot be resumed, translating from the start");
+      return false;
+   }
+
+   open_translation_file(translated_size);
+   if (write_trimmed_) {
+      open_at(trimmed_file, trim_file_name_, trimmed_size);
+   }
+   pair_open_ = std::move(pair_open);
+   translations = std::move(pending);
+   trans_count = std::move(counts);
+   first_index_ = std::move(first_index);
+   flushed_ = flushed;
+   flush_at_ = std::max(flush_batch, 2 * translations.size());
+   // any held back translation with a ${count} can still be counted
+   first_open_ = std::string::npos;
+   for (std::size_t index = 0; counts_open_ && index < translations.size(); ++index) {
+      if (translations[index].find(count_placeholder) != std::string_view::npos) {
+         first_open_ = flushed_ + index;
+         break;
+      }
+   }
+   spdlog::info("Resuming {} at byte {}", checkpoint_file_, input_offset);
+   return true;
+}
+
+void Translator::start_translation(std::string const& trace_file_name, LineReader& trace_file,
+                                   std::ofstream& trimmed_file)
+{
+   trim_file_name_ = trace_file_name + ".trim.log";
+   checkpoint_file_ = trace_file_name + ".checkpoint";
+   std::error_code error;
+   input_size_ = fs::file_size(trace_file_name, error);
+   input_time_ = fs::last_write_time(trace_file_name, error).time_since_epoch().count();
+   const bool compressed = trace_file.compressed() != compression::none;
+   // without rules that change lines the trimmed file would be a copy of the input
+   write_trimmed_ = changes_input();
+   recompress_ = write_trimmed_ && compressed && compress_trimmed_;
+   replace_input_ = write_trimmed_ && (!compressed || recompress_);
+   // replaced lines are rewritten into one buffer, only views into a mapped input stay valid
+   join_trimmed_ = trace_file.is_mapped() && config_.get_replace_words().empty();
+   trimmed_run_ = {};
+
+   if (recompress_ && resume_) {
+      spdlog::warn("Compressed trimmed files are not checkpointed, translating from the start");
+   }
+   if (recompress_ || !resume_ || !resume_from_checkpoint(trace_file, trimmed_file)) {
+      if (write_trimmed_) {
+         trimmed_file.open(trim_file_name_, recompress_ ? std::ios::out | std::ios::binary : std::ios::out);
+      }
+      open_translation_file();
+      add_pre_text();
+   }
+   next_checkpoint_ = (checkpoint_interval_ == 0 || recompress_) ? no_checkpoint
+                                                                 : trace_file.offset() + checkpoint_interval_;
+}
+
+void Translator::finish_translation(std::string const& trace_file_name, LineReader& trace_file,
+                                    std::ofstream& trimmed_file)
+{
+   next_checkpoint_ = no_checkpoint;
+   write_translation_file();
+   trimmed_file.close();
+   trace_file.close();
+
+   std::error_code error;
+   fs::remove(checkpoint_file_, error);
+   if (!replace_input_) {
+      // an input without trimmed file and a compressed input stay as they are, the trimmed lines
+      // of a compressed input are kept next to it
+      return;
+   }
+   // The trimmed file replaces the input in one rename, the input is never missing. The checkpoint
+   // went first, it would not match the replaced input anyway.
+   sync_file(trim_file_name_);
+   fs::rename(trim_file_name_, trace_file_name, error);
+   if (error) {
+      spdlog::error("{} could not replace {} : {}", trim_file_name_, trace_file_name, error.message());
    }
 }
 
 void Translator::translate_file(std::string const& trace_file_name)
 {
    spdlog::debug("translate_file");
-   std::ifstream trace_file(trace_file_name, std::ios::binary);
-   const std::string trim_file_name = trace_file_name + ".trim.log";
-   std::ofstream trimmed_file(trim_file_name);
+   stage_clock total_clock(stats());
+   LineReader trace_file(trace_file_name, threads_);
+   std::ofstream trimmed_file;
+   start_translation(trace_file_name, trace_file, trimmed_file);
+   std::optional<CompressingBuffer> compressed;
+   if (recompress_) {
+      compressed.emplace(trimmed_file.rdbuf(), trace_file.compressed());
+   }
+   // trimmed lines are written on a thread of their own, compressed there too
+   std::optional<AsyncWriteBuffer> writer;
+   if (write_trimmed_) {
+      writer.emplace(compressed ? static_cast<std::streambuf*>(&*compressed) : trimmed_file.rdbuf());
+   }
+   std::ostream trimmed(writer ? &*writer : nullptr);
+
+   if (threads_ > 1) {
+      translate_chunks(trace_file, trimmed);
+   }
+   else {
+      translate_lines(trace_file, trimmed);
+   }
+   stage_clock clock(stats());
+   const bool written = !writer || writer->finish();
+   if (!written || (compressed && !compressed->finish())) {
+      spdlog::error("{} could not be written", trim_file_name_);
+   }
+   finish_translation(trace_file_name, trace_file, trimmed_file);
+   clock.lap(&translate_stats::output_time);
+   total_clock.lap(&translate_stats::total_time);
+}
+
+void Translator::enable_stats()
+{
+   collect_stats_ = true;
+   stats_ = {};
+   stats_.translations.resize(config_.get_translations().size());
+}
+
+void Translator::start_follow()
+{
+   open_translation_file();
    add_pre_text();
+   follow_input_.close();
+   follow_identity_.reset();
+   follow_offset_ = 0;
+   follow_partial_.clear();
+   committed_ = 0;
+   rendered_.clear();
+   rendered_first_ = 0;
+   rendered_end_ = 0;
+   recounted_.clear();
+}
 
-   for (std::string line; getline(trace_file, line, '\n');) {
-      if (line.back() == '\n') line.pop_back();
-      if (line.back() == '\r') line.pop_back();
-      if (is_deleted(line)) {
-         continue;
+bool Translator::read_appended(std::string const& trace_file_name)
+{
+   // identified before the rest of the open file is read, the lines written to a rotated log before
+   // it was renamed are read from it
+   const auto identity = FileWatcher::identify(trace_file_name);
+   bool appended = follow_input_.is_open() && read_followed();
+   if (follow_input_.is_open() && (!identity || identity == follow_identity_)) {
+      return appended;
+   }
+   if (follow_input_.is_open()) {
+      // renamed and created again like a rotated log, the new file is followed from its start
+      appended = !follow_partial_.empty() || appended;
+      translate_partial();
+      follow_input_.close();
+   }
+   follow_input_.clear();
+   follow_input_.open(trace_file_name, std::ios::binary);
+   follow_identity_ = FileWatcher::identify(trace_file_name);
+   follow_offset_ = 0;
+   return (follow_input_.is_open() && read_followed()) || appended;
+}
+
+bool Translator::read_followed()
+{
+   follow_input_.clear();
+   follow_input_.seekg(0, std::ios::end);
+   const auto size = static_cast<std::uintmax_t>(follow_input_.tellg());
+   if (size < follow_offset_) {
+      // truncated, the new content is translated from its start
+      follow_offset_ = 0;
+      follow_partial_.clear();
+   }
+   follow_input_.seekg(static_cast<std::streamoff>(follow_offset_));
+   const std::uintmax_t read_from = follow_offset_;
+
+   while (follow_offset_ < size) {
+      const std::size_t filled = follow_partial_.size();
+      const auto block = static_cast<std::size_t>(std::min<std::uintmax_t>(chunk_size_, size - follow_offset_));
+      follow_partial_.resize(filled + block);
+      follow_input_.read(follow_partial_.data() + filled, static_cast<std::streamsize>(block));
+      const auto read = static_cast<std::size_t>(follow_input_.gcount());
+      follow_partial_.resize(filled + read);
+      follow_offset_ += read;
+      if (read == 0) {
+         break;
+      }
+
+      // only complete lines are translated, the last one may still be written to
+      std::string_view lines(follow_partial_);
+      for (auto line_end = lines.find('\n'); line_end != std::string_view::npos; line_end = lines.find('\n')) {
+         std::string_view line = lines.substr(0, line_end);
+         lines.remove_prefix(line_end + 1);
+         if (trim(&line)) {
+            translate(line);
+         }
       }
-      replace_words(&line);
-      write_to_file(line, trimmed_file);
+      follow_partial_.erase(0, follow_partial_.size() - lines.size());
+   }
+   return follow_offset_ != read_from;
+}
+
+void Translator::translate_partial()
+{
+   // the last line is complete once the file is no longer written to
+   std::string_view line(follow_partial_);
+   if (!line.empty() && trim(&line)) {
       translate(line);
    }
-   update_count();
-   validate_pairs();
+   follow_partial_.clear();
+}
+
+void Translator::render_pending()
+{
+   // Translations that became final are written over their rendering. The bytes are the same,
+   // unless a count changed its number of digits since, which renders everything after them again.
+   flush_translations(false);
+   committed_ = static_cast<std::uintmax_t>(translation_file_.tellp());
+   const std::size_t finished = std::min(flushed_ - rendered_first_, rendered_.size());
+   rendered_.erase(begin(rendered_), begin(rendered_) + static_cast<std::ptrdiff_t>(finished));
+   rendered_first_ = flushed_;
+   if (!rendered_.empty() && rendered_.front().at != committed_) {
+      rendered_.clear();
+   }
+   if (rendered_.empty()) {
+      rendered_end_ = committed_;
+      rendered_pairs_ = pair_open_;
+   }
+   render_from(patch_counts());
+
+   // Translations held back since the last update are rendered after the others, with the counts and
+   // pairs known so far. Pair states are kept apart, the final ones continue from committed_.
+   translation_file_.seekp(static_cast<std::streamoff>(rendered_end_));
+   const auto& pairs = config_.get_pairs();
+   std::vector<std::size_t> errors;
+   pair_open_.swap(rendered_pairs_);
+   for (std::size_t i = rendered_.size(); i < translations.size(); ++i) {
+      const std::string_view translation = apply_count(flushed_ + i, translations[i]);
+      const auto at = static_cast<std::uintmax_t>(translation_file_.tellp());
+      errors.clear();
+      check_pairs(translation, &errors);
+      for (const auto error : errors) {
+         write_translation(pairs[error].error);
+      }
+      rendered_.push_back({at, static_cast<std::uintmax_t>(translation_file_.tellp()), trans_count[i].count});
+      write_translation(translation);
+   }
+   pair_open_.swap(rendered_pairs_);
+   rendered_end_ = static_cast<std::uintmax_t>(translation_file_.tellp());
    add_post_text();
+
+   translation_file_.flush();
+   std::error_code error;
+   fs::resize_file(config_.get_translation_file(), static_cast<std::uintmax_t>(translation_file_.tellp()), error);
+   // translations flushed while reading are written right behind the final ones
+   translation_file_.seekp(static_cast<std::streamoff>(committed_));
+}
+
+std::size_t Translator::patch_counts()
+{
+   // a count with as many digits as the one rendered is written over it
+   std::size_t changed_width = rendered_.size();
+   for (const auto number : recounted_) {
+      if (number >= rendered_first_ && number - rendered_first_ < rendered_.size()) {
+         const std::size_t index = number - rendered_first_;
+         auto& shown = rendered_[index];
+         shown.recounted = false;
+         count_digits shown_digits{};
+         count_digits digits{};
+         if (format_count(shown.count, &shown_digits).size() !=
+             format_count(trans_count[index].count, &digits).size()) {
+            changed_width = std::min(changed_width, index);
+         }
+      }
+   }
+
+   for (const auto number : recounted_) {
+      if (number < rendered_first_ || number - rendered_first_ >= changed_width) {
+         continue;
+      }
+      const std::size_t index = number - rendered_first_;
+      auto& shown = rendered_[index];
+      count_digits digits{};
+      const std::string_view count = format_count(trans_count[index].count, &digits);
+      const std::string_view translation = translations[index];
+      std::uintmax_t at = shown.text;
+      std::size_t copied = 0;
+      for (auto found = trans_count[index].placeholder; found != std::string_view::npos;
+           found = translation.find(count_placeholder, copied)) {
+         at += found - copied;
+         translation_file_.seekp(static_cast<std::streamoff>(at));
+         translation_file_.write(count.data(), static_cast<std::streamsize>(count.size()));
+         at += count.size();
+         copied = found + count_placeholder.size();
+      }
+      shown.count = trans_count[index].count;
+   }
+   recounted_.clear();
+   return changed_width;
+}
+
+void Translator::render_from(std::size_t index)
+{
+   if (index >= rendered_.size()) {
+      return;
+   }
+   rendered_end_ = rendered_[index].at;
+   rendered_.erase(begin(rendered_) + static_cast<std::ptrdiff_t>(index), end(rendered_));
+
+   // the pair states after the translations that stay are found again
+   std::vector<std::size_t> errors;
+   rendered_pairs_ = pair_open_;
+   pair_open_.swap(rendered_pairs_);
+   for (std::size_t i = 0; i < index; ++i) {
+      errors.clear();
+      check_pairs(apply_count(flushed_ + i, translations[i]), &errors);
+   }
+   pair_open_.swap(rendered_pairs_);
+}
+
+void Translator::finish_follow(std::string const& trace_file_name)
+{
+   read_appended(trace_file_name);
+   translate_partial();
+   follow_input_.close();
+   // the final translations end where the file is written, translations may have been flushed while reading
+   committed_ = static_cast<std::uintmax_t>(translation_file_.tellp());
+   translation_file_.flush();
+   std::error_code error;
+   fs::resize_file(config_.get_translation_file(), committed_, error);
+   rendered_.clear();
+   recounted_.clear();
    write_translation_file();
-   translations.clear();
-   trimmed_file.close();
-   trace_file.close();
-   remove(trace_file_name.c_str());
-   rename(trim_file_name.c_str(), trace_file_name.c_str());
+}
+
+void Translator::follow_file(std::string const& trace_file_name, std::atomic_bool const& stop)
+{
+   spdlog::debug("follow_file");
+   FileWatcher watcher(trace_file_name);
+   start_follow();
+   read_appended(trace_file_name);
+   render_pending();
+   while (!stop && watcher.wait()) {
+      // an update without new data leaves the translation file as it is
+      if (read_appended(trace_file_name)) {
+         render_pending();
+      }
+   }
+   finish_follow(trace_file_name);
+}
+
+void Translator::set_checkpoint_interval(std::uintmax_t interval) noexcept
+{
+   checkpoint_interval_ = interval;
+}
+
+void Translator::set_resume(bool resume) noexcept
+{
+   resume_ = resume;
+}
+
+void Translator::set_compress_trimmed(bool compress) noexcept
+{
+   compress_trimmed_ = compress;
+}
+
+void Translator::set_threads(unsigned threads) noexcept
+{
+   threads_ = (threads == 0) ? std::max(1U, std::thread::hardware_concurrency()) : threads;
 }
 
 void Translator::execute_commands()
@@ -1,10 +1,23 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <optional>
 #include <regex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include "config_types.h"
 #include "configparser.h"
+#include "file_watcher.h"
+#include "translate_stats.h"
+#include "translation_arena.h"
+
+class LineReader;
 
 namespace unit_test {
 class TranslatorTesterProxy;
@@ -16,32 +29,155 @@ class TranslatorTesterProxy;
  *
  */
 class Translator {
+   /**
+    * @brief Trimmed lines and translations of a block of input lines, in input order
+    *
+    */
+   struct translated_chunk {
+      std::string trimmed;
+      std::vector<std::pair<std::string, Logalizer::Config::duplicates_t>> translations;
+      translate_stats stats;  /// of the worker that translated the chunk, when stats are collected
+   };
+
+   /**
+    * @brief Hash that lets first_index_ be searched with a string_view
+    *
+    */
+   struct text_hash {
+      using is_transparent = void;
+      std::size_t operator()(std::string_view text) const noexcept
+      {
+         return std::hash<std::string_view>{}(text);
+      }
+   };
+
+   /**
+    * @brief Duplicates counted for a translation that is not written yet
+    *
+    */
+   struct count_entry {
+      std::size_t count = 0;                             /// 0 for a translation that is not counted
+      std::size_t placeholder = std::string_view::npos;  /// of the first ${count} in the translation
+   };
+
+   /**
+    * @brief A held back translation as it is shown in the followed translation file
+    *
+    */
+   struct rendered_translation {
+      std::uintmax_t at;       /// where its pair errors start in the translation file
+      std::uintmax_t text;     /// where the translation itself starts
+      std::size_t count;       /// spliced into its ${count}
+      bool recounted = false;  /// its count changed since it was rendered
+   };
+
+   static constexpr std::size_t flush_batch = 1024;
+   static constexpr std::string_view count_placeholder = "${count}";
+   static constexpr std::uintmax_t no_checkpoint = std::numeric_limits<std::uintmax_t>::max();
+
    std::string fetch_values_regex(std::string const& line, std::vector<Logalizer::Config::variable> const& variables);
    std::string fetch_values_braced(std::string const& line, std::vector<Logalizer::Config::variable> const& variables);
-   std::string capture_values(Logalizer::Config::variable const& var, std::string const& content);
-   std::vector<std::string> variable_values(std::string const& line,
-                                            std::vector<Logalizer::Config::variable> const& variables);
-   std::string pack_parameters(std::vector<std::string> const& v);
-   std::string fill_values(std::string const& line, Logalizer::Config::translation const& tr);
-   std::string fill_values_formatted(std::vector<std::string> const& values, std::string const& line_to_fill);
-   std::string update_variables(std::vector<std::string> const& values, std::string const& line_to_fill);
-   [[nodiscard]] bool is_blacklisted(std::string const& line);
-   auto get_matching_translator(std::string const& line);
-   [[nodiscard]] bool is_deleted(std::string const& line) noexcept;
-   [[nodiscard]] bool matches_pattern(std::string const& line, std::vector<std::string>& patterns) const;
-   [[nodiscard]] bool matches_pattern(std::string const& line, std::string& pattern) const;
+   [[nodiscard]] static std::string_view capture_values(Logalizer::Config::variable_search const& var,
+                                                        std::string_view content) noexcept;
+   std::vector<std::string_view> const& variable_values(
+       std::string_view line, std::vector<Logalizer::Config::variable_search> const& variables);
+   std::string_view fill_values(std::string_view line, Logalizer::Config::translation const& tr);
+   std::string_view fill_values_formatted(std::vector<std::string_view> const& values,
+                                          Logalizer::Config::translation const& tr);
+   [[nodiscard]] bool is_blacklisted(std::string_view line);
+   std::vector<Logalizer::Config::translation>::const_iterator get_matching_translator(std::string_view line);
+   [[nodiscard]] bool is_deleted(std::string_view line) noexcept;
+   [[nodiscard]] bool matches_delete_regex(std::string_view line) noexcept;
+   void replace_all(std::string* line, Logalizer::Config::replacement const& entry);
    void replace_words(std::string* line);
-   void add_translation(std::string&& translation, Logalizer::Config::duplicates_t duplicates);
-   void validate_pairs();
-   void update_count();
+   [[nodiscard]] std::size_t find_first(std::string_view translation) const;
+   void append_translation(std::string_view translation);
+   void add_translation(std::string_view translation, Logalizer::Config::duplicates_t duplicates);
+   void check_pairs(std::string_view line, std::vector<std::size_t>* errors);
+   count_entry& add_count(std::size_t index, std::string_view translation);
+   std::string_view apply_count(std::size_t index, std::string_view translation);
    void add_pre_text();
    void add_post_text();
+   void open_translation_file(std::uintmax_t resume_at = 0);
+   void write_translation(std::string_view translation);
+   void flush_translations(bool finished);
    void write_translation_file();
-   void write_to_file(std::string const& line, std::ofstream& trimmed_file);
-   void translate(std::string const& line);
+   [[nodiscard]] bool changes_input() const noexcept;
+   void write_to_file(std::string_view line, std::ostream& trimmed_file);
+   void write_trimmed_run(std::ostream& trimmed_file);
+   [[nodiscard]] bool trim(std::string_view* line);
+   void count_translation(std::vector<Logalizer::Config::translation>::const_iterator trcfg,
+                          translate_stats::duration cost);
+   void translate(std::string_view line);
+   translated_chunk translate_chunk(std::string_view lines);
+   void merge_chunk(translated_chunk&& chunk, std::ostream& trimmed_file);
+   void translate_lines(LineReader& trace_file, std::ostream& trimmed_file);
+   void translate_chunks(LineReader& trace_file, std::ostream& trimmed_file);
+   void checkpoint(std::uintmax_t input_offset, std::ostream& trimmed_file);
+   void save_checkpoint(std::uintmax_t input_offset, std::ostream& trimmed_file);
+   [[nodiscard]] bool resume_from_checkpoint(LineReader& trace_file, std::ofstream& trimmed_file);
+   void start_translation(std::string const& trace_file_name, LineReader& trace_file, std::ofstream& trimmed_file);
+   void finish_translation(std::string const& trace_file_name, LineReader& trace_file, std::ofstream& trimmed_file);
+   void start_follow();
+   bool read_appended(std::string const& trace_file_name);
+   bool read_followed();
+   void translate_partial();
+   void render_pending();
+   [[nodiscard]] std::size_t patch_counts();
+   void render_from(std::size_t index);
+   void finish_follow(std::string const& trace_file_name);
    const Logalizer::Config::ConfigParser& config_;
-   std::vector<std::string> translations;
-   std::unordered_map<size_t, size_t> trans_count;
+   TranslationArena translations;  /// translations not written yet, the first one is number flushed_
+   std::ofstream translation_file_;
+   std::size_t flushed_ = 0;  /// translations already written to translation_file_
+   std::size_t flush_at_ = flush_batch;
+   bool index_translations_ = false;  /// remove or count duplicates look up earlier translations
+   bool counts_open_ = false;         /// count duplicates may update any earlier ${count}
+   std::size_t first_open_ = std::string::npos;  /// number of the first translation with a ${count} that can change
+   std::string replaced_line_;
+   std::string replace_buffer_;
+   std::string print_buffer_;
+   std::string count_buffer_;  /// a translation with its counts spliced in
+   std::vector<std::string_view> value_slots_;  /// captured variables, views into the line being translated
+   bool blacklist_known_ = false;  /// line_blacklisted_ holds the result for the line trim returned
+   bool line_blacklisted_ = false;
+   Logalizer::Config::TranslationMatcher::scratch match_scratch_;
+   Logalizer::Config::PairMatcher::scratch pair_scratch_;
+   std::vector<bool> pair_open_;  /// per pair, source found and neither pairswith nor before found yet
+   [[nodiscard]] translate_stats* stats() noexcept
+   {
+      return collect_stats_ ? &stats_ : nullptr;
+   }
+   std::ifstream follow_input_;                            /// the followed file, kept open until it is rotated
+   std::optional<FileWatcher::identity> follow_identity_;  /// the file follow_input_ reads
+   std::uintmax_t follow_offset_ = 0;  /// bytes of the followed file that are read
+   std::string follow_partial_;        /// read bytes of the followed file after its last complete line
+   std::uintmax_t committed_ = 0;      /// bytes of the translation file that are final
+   std::deque<rendered_translation> rendered_;  /// shown behind committed_, the first one is number rendered_first_
+   std::size_t rendered_first_ = 0;
+   std::uintmax_t rendered_end_ = 0;            /// where the rendered translations end and the post text starts
+   std::vector<bool> rendered_pairs_;           /// pair_open_ after the rendered translations
+   std::vector<std::size_t> recounted_;         /// numbers of rendered translations whose count changed
+   std::uintmax_t checkpoint_interval_ = std::uintmax_t{256} << 20U;  /// input bytes between checkpoints
+   std::uintmax_t next_checkpoint_ = no_checkpoint;                   /// input offset of the next checkpoint
+   bool resume_ = false;
+   std::string checkpoint_file_;
+   std::string trim_file_name_;
+   std::uintmax_t input_size_ = 0;  /// of the translated file, a checkpoint only resumes the same input
+   std::int64_t input_time_ = 0;
+   bool compress_trimmed_ = false;
+   bool recompress_ = false;     /// the trimmed file is compressed like the input
+   bool replace_input_ = false;  /// the trimmed file replaces the input
+   bool write_trimmed_ = true;     /// delete_lines or replace_words change the input, it is trimmed
+   bool join_trimmed_ = false;     /// kept lines are views into the mapped input, neighbours are joined
+   std::string_view trimmed_run_;  /// kept lines that follow each other in the input, not written yet
+   bool collect_stats_ = false;
+   translate_stats stats_;
+   unsigned threads_ = 1;
+   std::size_t chunk_size_ = std::size_t{4} << 20U;
+   std::deque<count_entry> trans_count;  /// one per translation not written yet, aligned with translations
+   /// text -> number of its first translation
+   std::unordered_map<std::string, size_t, text_hash, std::equal_to<>> first_index_;
 
   public:
    /**
@@ -55,22 +191,94 @@ class Translator {
    {
    }
 
+   /**
+    * @brief Set the number of threads used by translate_file
+    *
+    * With more than one thread the input is split into blocks of whole lines that are trimmed and
+    * translated concurrently. Outputs are merged in input order, so the result is the same as with
+    * a single thread. 0 uses one thread per hardware thread.
+    *
+    * @param threads
+    */
+   void set_threads(unsigned threads) noexcept;
+
+   /**
+    * @brief Set how often translate_file saves a checkpoint
+    *
+    * @param interval input bytes between checkpoints, 0 disables checkpoints
+    */
+   void set_checkpoint_interval(std::uintmax_t interval) noexcept;
+
+   /**
+    * @brief Let the following translate_file calls continue from the checkpoint of an interrupted run
+    *
+    * Without a usable checkpoint the file is translated from its start. A checkpoint is only used
+    * for the same unmodified input, the configuration must not have changed either.
+    *
+    * @param resume
+    */
+   void set_resume(bool resume) noexcept;
+
+   /**
+    * @brief Write the trimmed lines of a compressed input back in its compression format
+    *
+    * By default a compressed input is kept as it is and its trimmed lines are left uncompressed in
+    * <trace_file_name>.trim.log. When they are compressed they replace the input, but no checkpoints
+    * are saved.
+    *
+    * @param compress
+    */
+   void set_compress_trimmed(bool compress) noexcept;
+
+   /**
+    * @brief Collect translate_stats in the following translate_file calls
+    *
+    * Counters and stage times add up over all the files translated after this call.
+    * With more than one thread stage times add up the time of all threads.
+    */
+   void enable_stats();
+
+   /**
+    * @brief Get the stats collected since enable_stats
+    *
+    * @return translate_stats const&
+    */
+   [[nodiscard]] translate_stats const& get_stats() const noexcept
+   {
+      return stats_;
+   }
+
    /**
     * @brief Translate input file line by line
     *
     * Algorithm
     *
     * 1. Writes contents of wrap_text_pre to translation file
-    * 2. Parse intput file line by line
+    * 2. Parse intput file line by line. Regular files are memory mapped, other inputs are streamed.
+    *    gzip, zstd and lz4 files are decompressed on another thread
     * 3. Removes lines matching delete_lines in input file
     * 4. Replaces text in input file as configured in replace_words
     * 5. If a line is blacklisted, parse next line
     * 6. If a line matches all the patterns, prepare to write contents of print to translation file
     * 7. Update the print line variables with values as configured in variables
     * 8. Handle duplicates in translation file as per configuration
-    * 9. After parsing all lines, update count variables in translation file
-    * 10. Write to translation file
+    * 9. Write translations as soon as they are final, with pair errors inserted before them.
+    *    Translations whose ${count} can still change are held back until the end of the input
+    * 10. After parsing all lines, update count variables and write the remaining translations
     * 11. Writes contents of wrap_text_post
+    * 12. Replaces the input file with the trimmed file in one rename
+    *
+    * Without delete_lines and replace_words the trimmed file would be a copy of the input, it is not
+    * written and the input is left untouched. Otherwise kept lines that follow each other in a mapped
+    * input are written in one piece.
+    *
+    * The trimmed lines are collected in large buffers that a writer thread writes to the trimmed file,
+    * so writing them does not hold up the translation.
+    *
+    * Every checkpoint interval of input the read offset, the duplicate, count and pair states and
+    * the sizes of the trimmed and translation files are saved to <trace_file_name>.checkpoint.
+    * A run killed before the end can be continued from there with set_resume, the checkpoint is
+    * removed once the translation is complete.
     *
     *  @startuml{myimage.png} "" width=5cm
     *    start
@@ -94,6 +302,24 @@ class Translator {
     */
    void translate_file(std::string const& trace_file_name);
 
+   /**
+    * @brief Translate a file that is still being written to, like tail -f
+    *
+    * The file is watched and only appended lines are translated, duplicates, counts and pairs
+    * are kept across updates. Final translations are appended to the translation file, the ones
+    * that can still change are rewritten after them on every update, followed by wrap_text_post.
+    * Lines without a line terminator wait for it.
+    *
+    * The input file is not rewritten, delete_lines and replace_words only apply to the translation.
+    * Following ends when stop is set or the file is removed, or renamed and not created again. A file
+    * that is renamed and created again under its name, like a rotated log, is read to its end and the
+    * new file is followed from its start. If the file shrinks it is translated again from its start.
+    *
+    * @param trace_file_name
+    * @param stop
+    */
+   void follow_file(std::string const& trace_file_name, std::atomic_bool const& stop);
+
    /**
     * @brief Execute configured commands one by one
     *
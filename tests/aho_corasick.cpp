@@ -0,0 +1,103 @@
+#include "aho_corasick.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace Logalizer::Config;
+
+namespace {
+std::vector<std::pair<std::uint32_t, std::size_t>> matches(AhoCorasick const& ac, std::string_view text)
+{
+   std::vector<std::pair<std::uint32_t, std::size_t>> found;
+   std::size_t count = 0;
+   ac.scan(text, [&](std::uint32_t id) {
+      found.emplace_back(id, count++);
+      return true;
+   });
+   return found;
+}
+}  // namespace
+
+TEST_CASE("AhoCorasick reports overlapping patterns")
+{
+   const AhoCorasick ac({"he", "she", "his", "hers"});
+
+   std::vector<std::uint32_t> ids;
+   ac.scan("ushers", [&ids](std::uint32_t id) {
+      ids.push_back(id);
+      return true;
+   });
+   CHECK(ids == std::vector<std::uint32_t>{1, 0, 3});
+}
+
+TEST_CASE("AhoCorasick contains_any")
+{
+   const AhoCorasick ac({"d1", "delete me"});
+   CHECK(ac.contains_any("please delete me now"));
+   CHECK(ac.contains_any("d1"));
+   CHECK_FALSE(ac.contains_any("delete m"));
+   CHECK_FALSE(ac.contains_any(""));
+}
+
+TEST_CASE("AhoCorasick stops when asked")
+{
+   const AhoCorasick ac({"a"});
+   std::size_t calls = 0;
+   CHECK_FALSE(ac.scan("aaaa", [&calls](std::uint32_t) { return ++calls < 2; }));
+   CHECK(calls == 2);
+}
+
+TEST_CASE("AhoCorasick duplicate and empty patterns")
+{
+   const AhoCorasick ac({"", "ab", "ab"});
+   CHECK(ac.size() == 3);
+   CHECK(matches(ac, "xabx").size() == 1);
+   CHECK(matches(ac, "xabx").front().first == 1);
+   CHECK(matches(ac, "xyz").empty());
+}
+
+TEST_CASE("AhoCorasick without patterns")
+{
+   const AhoCorasick ac;
+   CHECK_FALSE(ac.contains_any("anything"));
+}
+
+TEST_CASE("AhoCorasick skips bytes that cannot start a pattern")
+{
+   // few start bytes use the block compare, many use the table, matches may straddle a 16 byte block
+   const std::string filler(40, '.');
+   for (auto const& patterns : {std::vector<std::string>{"xyz"}, std::vector<std::string>{"xyz", "abc", "mno"},
+                                std::vector<std::string>{"xyz", "abc", "mno", "qrs", "efg"}}) {
+      const AhoCorasick ac(patterns);
+      for (std::size_t at = 0; at < 20; ++at) {
+         const std::string text = filler.substr(0, at) + "xyxyz" + filler;
+         CHECK(matches(ac, text).size() == 1);
+         CHECK(matches(ac, filler.substr(0, at) + "xy" + filler + "z").empty());
+      }
+   }
+}
+
+TEST_CASE("AhoCorasick bigram skip finds what a plain search finds")
+{
+   // many first bytes skip by byte pairs, a single byte pattern makes all pairs with it a start
+   const std::vector<std::string> patterns = {"ab", "bcd", "cab", "dd", "ea", "fab", "g", "hhh", "abcab"};
+   const AhoCorasick ac(patterns);
+   const std::string alphabet = "abcdefgh.";
+   std::uint32_t seed = 7;
+   for (int round = 0; round < 200; ++round) {
+      std::string text;
+      for (int i = 0; i < round % 50; ++i) {
+         seed = seed * 1103515245U + 12345U;
+         text += alphabet[(seed >> 16U) % alphabet.size()];
+      }
+      std::size_t expected = 0;
+      for (auto const& pattern : patterns) {
+         for (auto at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1)) {
+            ++expected;
+         }
+      }
+      CHECK(matches(ac, text).size() == expected);
+   }
+}
@@ -0,0 +1,89 @@
+#include "async_write_buffer.h"
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+namespace {
+/**
+ * @brief Accepts a limited number of bytes, like a full disk
+ *
+ */
+class LimitedBuffer : public std::stringbuf {
+  public:
+   explicit LimitedBuffer(std::streamsize limit) : limit_(limit)
+   {
+   }
+
+  protected:
+   std::streamsize xsputn(const char* text, std::streamsize size) override
+   {
+      const auto accepted = std::min(size, limit_);
+      limit_ -= accepted;
+      return std::stringbuf::xsputn(text, accepted);
+   }
+
+  private:
+   std::streamsize limit_;
+};
+}  // namespace
+
+TEST_CASE("AsyncWriteBuffer writes everything in order")
+{
+   std::stringbuf target;
+   std::string expected;
+   {
+      AsyncWriteBuffer writer(&target, 16);
+      std::ostream out(&writer);
+      for (int i = 0; i < 1000; ++i) {
+         const std::string line = "line " + std::to_string(i) + (i % 7 == 0 ? std::string(40, 'x') : "") + '\n';
+         out << line;
+         expected += line;
+      }
+      CHECK(out.good());
+      CHECK(static_cast<std::size_t>(out.tellp()) == expected.size());
+      CHECK(writer.finish());
+   }
+   CHECK(target.str() == expected);
+}
+
+TEST_CASE("AsyncWriteBuffer writes to the target only when full or flushed")
+{
+   std::stringbuf target;
+   AsyncWriteBuffer writer(&target, 64);
+   std::ostream out(&writer);
+   out << "first\n";
+   CHECK(target.str().empty());
+   out.flush();
+   CHECK(target.str() == "first\n");
+   out << "second\n";
+   CHECK(writer.finish());
+   CHECK(target.str() == "first\nsecond\n");
+   // finishing again changes nothing
+   CHECK(writer.finish());
+}
+
+TEST_CASE("AsyncWriteBuffer continues the position of its target")
+{
+   std::stringbuf target;
+   target.sputn("kept\n", 5);
+   AsyncWriteBuffer writer(&target, 8);
+   std::ostream out(&writer);
+   CHECK(out.tellp() == 5);
+   out << "added\n";
+   CHECK(out.tellp() == 11);
+   CHECK(writer.finish());
+   CHECK(target.str() == "kept\nadded\n");
+}
+
+TEST_CASE("AsyncWriteBuffer reports a failed write")
+{
+   LimitedBuffer target(10);
+   AsyncWriteBuffer writer(&target, 8);
+   std::ostream out(&writer);
+   out << std::string(100, 'x');
+   out.flush();
+   CHECK_FALSE(out.good());
+   CHECK_FALSE(writer.finish());
+}
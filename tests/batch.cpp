@@ -0,0 +1,157 @@
+#include "batch.h"
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using Logalizer::Config::json;
+using Logalizer::Config::JsonConfigParser;
+
+namespace {
+fs::path make_batch_dir(std::string const& name)
+{
+   const fs::path dir = fs::temp_directory_path() / name;
+   fs::remove_all(dir);
+   fs::create_directories(dir);
+   return dir;
+}
+
+std::string read_all(fs::path const& file)
+{
+   std::ifstream in(file);
+   std::stringstream content;
+   content << in.rdbuf();
+   return content.str();
+}
+}  // namespace
+
+TEST_CASE("expand_inputs matches wildcards in file names")
+{
+   const fs::path dir = make_batch_dir("logalizer_expand");
+   for (auto const* name : {"b.log", "a.log", "ab.log", "a.txt"}) {
+      std::ofstream(dir / name) << "line\n";
+   }
+   const std::string base = dir.string() + "/";
+
+   CHECK(expand_inputs({base + "*.log"}) == std::vector<std::string>{base + "a.log", base + "ab.log", base + "b.log"});
+   CHECK(expand_inputs({base + "?.log"}) == std::vector<std::string>{base + "a.log", base + "b.log"});
+   CHECK(expand_inputs({base + "a*"}) == std::vector<std::string>{base + "a.log", base + "a.txt", base + "ab.log"});
+   // files given twice are kept once at their first position
+   CHECK(expand_inputs({base + "b.log", base + "?.log"}) == std::vector<std::string>{base + "b.log", base + "a.log"});
+   // unmatched patterns and plain names are kept for the caller to report
+   CHECK(expand_inputs({base + "*.gz", base + "missing.log"}) ==
+         std::vector<std::string>{base + "*.gz", base + "missing.log"});
+   fs::remove_all(dir);
+}
+
+TEST_CASE("read_file_list skips blank lines and comments")
+{
+   const fs::path dir = make_batch_dir("logalizer_list");
+   std::ofstream(dir / "list.txt") << "# logs of today\none.log\r\n\n  two.log  \n\t\n";
+   std::vector<std::string> entries;
+   REQUIRE(read_file_list((dir / "list.txt").string(), &entries));
+   CHECK(entries == std::vector<std::string>{"one.log", "two.log"});
+   CHECK_FALSE(read_file_list((dir / "missing.txt").string(), &entries));
+   fs::remove_all(dir);
+}
+
+TEST_CASE("BatchTranslator translates every log with its own path variables")
+{
+   const fs::path dir = make_batch_dir("logalizer_batch");
+   std::vector<std::string> logs;
+   for (int i = 0; i < 6; ++i) {
+      const fs::path log = dir / ("device" + std::to_string(i) + ".log");
+      std::ofstream(log) << "boot\nvalue=" << i << ";\nnoise\n";
+      logs.push_back(log.string());
+   }
+   JsonConfigParser config(json::parse(R"({
+      "translations": [
+        {
+          "patterns": ["value="],
+          "print": "value ${1}",
+          "variables": [{"startswith": "value=", "endswith": ";"}]
+        }
+      ],
+      "wrap_text_pre": ["${fileBasenameNoExtension}"],
+      "translation_file": "${fileDirname}/${fileBasenameNoExtension}.txt"
+   })"));
+   config.set_path_variables(get_path_vars(logs.front()));
+   config.load_configurations();
+
+   BatchTranslator batch(config);
+   batch.set_jobs(3);
+   batch.enable_stats();
+   CHECK(batch.translate(logs) == 0);
+   for (int i = 0; i < 6; ++i) {
+      const std::string name = "device" + std::to_string(i);
+      CHECK(read_all(dir / (name + ".txt")) == name + "\nvalue " + std::to_string(i) + "\n");
+   }
+   CHECK(batch.get_stats().lines_read == 18);
+   CHECK(batch.get_stats().lines_translated == 6);
+   // the configuration given to the batch is left as it was
+   CHECK(config.get_translation_file() == (dir / "device0.txt").string());
+   fs::remove_all(dir);
+}
+
+TEST_CASE("BatchTranslator translates logs that share a translation file one after the other")
+{
+   const fs::path dir = make_batch_dir("logalizer_batch_shared");
+   std::vector<std::string> logs;
+   for (int i = 0; i < 3; ++i) {
+      const fs::path log = dir / ("device" + std::to_string(i) + ".log");
+      std::ofstream(log) << "value=" << i << ";\n";
+      logs.push_back(log.string());
+   }
+   logs.push_back((dir / "missing.log").string());
+   json j = json::parse(R"({
+      "translations": [
+        {
+          "patterns": ["value="],
+          "print": "value ${1}",
+          "variables": [{"startswith": "value=", "endswith": ";"}]
+        }
+      ]
+   })");
+   j["translation_file"] = (dir / "all.txt").string();
+   JsonConfigParser config(j);
+   config.load_configurations();
+
+   BatchTranslator batch(config);
+   batch.set_jobs(0);
+   CHECK(batch.translate(logs) == 1);
+   // every log rewrote the file, the last one that exists is left
+   CHECK(read_all(dir / "all.txt") == "value 2\n");
+   fs::remove_all(dir);
+}
+
+#if !defined(_WIN32)
+TEST_CASE("BatchTranslator runs the execute commands of one log at a time")
+{
+   const fs::path dir = make_batch_dir("logalizer_batch_execute");
+   std::vector<std::string> logs;
+   for (int i = 0; i < 4; ++i) {
+      const fs::path log = dir / ("device" + std::to_string(i) + ".log");
+      std::ofstream(log) << "value=" << i << ";\n";
+      logs.push_back(log.string());
+   }
+   json j = json::parse(R"({
+      "translations": [{"patterns": ["value="], "print": "value"}],
+      "translation_file": "${fileDirname}/${fileBasenameNoExtension}.txt"
+   })");
+   // a command that interleaves with itself when it runs for two logs at once
+   const std::string shared = (dir / "shared.txt").string();
+   j["execute"] = {"echo start >> " + shared + "; sleep 0.05; echo end >> " + shared};
+   JsonConfigParser config(j);
+   config.set_path_variables(get_path_vars(logs.front()));
+   config.load_configurations();
+
+   BatchTranslator batch(config);
+   batch.set_jobs(4);
+   CHECK(batch.translate(logs) == 0);
+   CHECK(read_all(shared) == "start\nend\nstart\nend\nstart\nend\nstart\nend\n");
+   fs::remove_all(dir);
+}
+#endif
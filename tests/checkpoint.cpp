@@ -0,0 +1,54 @@
+#include "checkpoint.h"
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+TEST_CASE("Checkpoint values are read back in order")
+{
+   const std::string file = (fs::temp_directory_path() / "values.checkpoint").string();
+   const std::string binary("a\0\nb", 4);
+   {
+      CheckpointWriter writer(file);
+      writer.put(std::uint64_t{0x0102030405060708});
+      writer.put(binary);
+      writer.put("");
+      REQUIRE(writer.commit());
+   }
+   CHECK_FALSE(fs::exists(file + ".tmp"));
+
+   CheckpointReader reader(file);
+   std::uint64_t value = 0;
+   std::string text;
+   CHECK(reader.get(&value));
+   CHECK(value == 0x0102030405060708);
+   CHECK(reader.get(&text));
+   CHECK(text == binary);
+   CHECK(reader.get(&text));
+   CHECK(text.empty());
+   CHECK_FALSE(reader.get(&value));
+}
+
+TEST_CASE("Checkpoint that is missing or damaged is not read")
+{
+   const std::string file = (fs::temp_directory_path() / "damaged.checkpoint").string();
+   std::uint64_t value = 0;
+   std::string text;
+
+   fs::remove(file);
+   CHECK_FALSE(CheckpointReader(file).get(&value));
+
+   std::ofstream(file, std::ios::binary) << "not a checkpoint";
+   CHECK_FALSE(CheckpointReader(file).get(&value));
+
+   {
+      CheckpointWriter writer(file);
+      writer.put("a text that is cut off");
+      REQUIRE(writer.commit());
+   }
+   fs::resize_file(file, fs::file_size(file) - 4);
+   CheckpointReader reader(file);
+   CHECK_FALSE(reader.get(&text));
+}
@@ -0,0 +1,170 @@
+#include "compiled_config.h"
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "jsonconfigparser.h"
+
+namespace fs = std::filesystem;
+using namespace Logalizer::Config;
+
+namespace {
+const auto full_config = json::parse(R"({
+   "translations": [
+     {
+       "group": "boot",
+       "patterns": ["boot", "ok"],
+       "print": "booted ${1}",
+       "variables": [{"startswith": "v=", "endswith": ";"}],
+       "duplicates": "count"
+     },
+     {
+       "patterns": ["shutdown"],
+       "print": "shutdown"
+     }
+   ],
+   "pairs": [
+     {"source": "open", "pairswith": "close", "before": "end", "error": "not closed"}
+   ],
+   "wrap_text_pre": ["title ${fileBasename}"],
+   "wrap_text_post": ["end"],
+   "blacklist": ["debug"],
+   "delete_lines": ["noise", "^trace.*x$", "a\\|b"],
+   "replace_words": {"secret": "***", "[0-9]+ms": "Nms"},
+   "execute": ["open ${fileDirname}/${fileBasenameNoExtension}.svg"],
+   "translation_file": "${fileDirname}/${fileBasenameNoExtension}.txt",
+   "backup_file": "${fileDirname}/backup/${fileBasename}",
+   "auto_new_line": false
+})");
+
+std::string write_compiled(std::string const& name, std::vector<std::string> const& sources)
+{
+   const std::string file = (fs::temp_directory_path() / name).string();
+   JsonConfigParser config(full_config);
+   config.load_configurations();
+   REQUIRE(config.save_compiled(file, sources));
+   return file;
+}
+}  // namespace
+
+TEST_CASE("compiled configuration loads what was saved")
+{
+   const std::string file = write_compiled("full.lzc", {});
+
+   JsonConfigParser config;
+   config.set_path_variables({"logs", "device.log", "device"});
+   REQUIRE(config.load_compiled(file));
+
+   auto const& trs = config.get_translations();
+   REQUIRE(trs.size() == 2);
+   CHECK(trs[0].category == "boot");
+   CHECK(trs[0].patterns == std::vector<std::string>{"boot", "ok"});
+   CHECK(trs[0].print == "booted ${1}");
+   REQUIRE(trs[0].variables.size() == 1);
+   CHECK(trs[0].variables[0].startswith == "v=");
+   CHECK(trs[0].variables[0].endswith == ";");
+   CHECK(trs[0].duplicates == duplicates_t::count);
+   REQUIRE(trs[0].print_format.size() == 2);
+   CHECK(trs[0].print_format[0].text == "booted ");
+   CHECK(trs[0].print_format[1].variable == 0);
+
+   TranslationMatcher::scratch work;
+   CHECK(config.get_translation_matcher().find("ok boot", work) == 0);
+   CHECK(config.get_translation_matcher().find("shutdown now", work) == 1);
+   CHECK(config.get_translation_matcher().find("boot", work) == 2);
+
+   REQUIRE(config.get_pairs().size() == 1);
+   CHECK(config.get_pairs()[0].error == "not closed");
+   PairMatcher::scratch found;
+   config.get_pair_matcher().find("open end", found);
+   CHECK(found.roles == std::vector<std::uint8_t>{PairMatcher::source | PairMatcher::before});
+
+   CHECK(config.get_delete_lines() == std::vector<std::string>{"noise"});
+   REQUIRE(config.get_delete_lines_linear().size() == 1);
+   CHECK(config.get_delete_lines_linear()[0].search("trace 1 x"));
+   CHECK_FALSE(config.get_delete_lines_linear()[0].search("trace 1 y"));
+   CHECK(config.get_delete_lines_regex().size() == 1);
+   CHECK(config.get_blacklists() == std::vector<std::string>{"debug"});
+   CHECK(config.get_line_filter().find("debug noise", LineFilter::deleted | LineFilter::blacklisted) ==
+         (LineFilter::deleted | LineFilter::blacklisted));
+   REQUIRE(config.get_replace_words().size() == 2);
+   CHECK(config.get_replace_words()[0].literal);
+   CHECK_FALSE(config.get_replace_words()[1].literal);
+   CHECK_FALSE(config.get_auto_new_line());
+
+   // path variables are expanded for the log set before loading, and again for every other log
+   CHECK(config.get_translation_file() == "logs/device.txt");
+   CHECK(config.get_backup_file() == "logs/backup/device.log");
+   CHECK(config.get_wrap_text_pre() == std::vector<std::string>{"title device.log"});
+   CHECK(config.get_wrap_text_post() == std::vector<std::string>{"end"});
+   CHECK(config.get_execute_commands() == std::vector<std::string>{"open logs/device.svg"});
+   config.set_path_variables({"other", "trace.log", "trace"});
+   CHECK(config.get_translation_file() == "other/trace.txt");
+   fs::remove(file);
+}
+
+TEST_CASE("compiled configuration older than a source is not loaded")
+{
+   const std::string source = (fs::temp_directory_path() / "source.json").string();
+   std::ofstream(source) << "{}";
+   const std::string file = write_compiled("stale.lzc", {source});
+
+   JsonConfigParser config;
+   CHECK(config.load_compiled(file));
+
+   fs::last_write_time(source, fs::last_write_time(file) + std::chrono::seconds(10));
+   JsonConfigParser stale;
+   CHECK_FALSE(stale.load_compiled(file));
+   CHECK(stale.get_translations().empty());
+
+   fs::remove(source);
+   CHECK_FALSE(stale.load_compiled(file));
+   fs::remove(file);
+}
+
+TEST_CASE("damaged compiled configuration is not loaded")
+{
+   const std::string file = write_compiled("damaged.lzc", {});
+   const auto size = fs::file_size(file);
+
+   SECTION("changed byte")
+   {
+      std::fstream data(file, std::ios::binary | std::ios::in | std::ios::out);
+      data.seekg(static_cast<std::streamoff>(size / 2));
+      const auto byte = static_cast<char>(data.get() ^ 0x20);
+      data.seekp(static_cast<std::streamoff>(size / 2));
+      data.put(byte);
+   }
+   SECTION("truncated")
+   {
+      fs::resize_file(file, size - 1);
+   }
+   SECTION("not a compiled configuration")
+   {
+      std::ofstream(file) << R"({"translations": []})";
+   }
+
+   JsonConfigParser config;
+   CHECK_FALSE(config.load_compiled(file));
+   CHECK(config.get_translations().empty());
+   CHECK_FALSE(config.load_compiled(file + ".missing"));
+   fs::remove(file);
+}
+
+TEST_CASE("CompiledConfigReader does not read past the end")
+{
+   CompiledConfigWriter out;
+   out.put_string("text");
+   out.put_vector(std::vector<std::uint32_t>{1, 2, 3});
+
+   CompiledConfigReader in(out.data());
+   CHECK(in.get_string() == "text");
+   CHECK(in.get_vector<std::uint32_t>() == std::vector<std::uint32_t>{1, 2, 3});
+   CHECK(in.at_end());
+   CHECK_THROWS_AS(in.get_value<std::uint64_t>(), std::runtime_error);
+
+   CompiledConfigReader truncated(std::string_view(out.data()).substr(0, 6));
+   CHECK_THROWS_AS(truncated.get_string(), std::runtime_error);
+}
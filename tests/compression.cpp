@@ -0,0 +1,187 @@
+#include "compression.h"
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "line_reader.h"
+
+#if defined(LOGALIZER_WITH_ZLIB)
+#include <zlib.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+void write_compressed(std::string const& file_name, std::string const& text, compression format,
+                      std::ios::openmode mode = std::ios::trunc)
+{
+   std::ofstream file(file_name, std::ios::binary | mode);
+   CompressingBuffer compressed(file.rdbuf(), format);
+   std::ostream(&compressed) << text;
+   REQUIRE(compressed.finish());
+}
+
+std::string read_lines(std::string const& file_name, unsigned threads)
+{
+   LineReader reader(file_name, threads);
+   std::string text;
+   for (std::string_view line; reader.getline(&line);) {
+      text.append(line).push_back('\n');
+   }
+   return text;
+}
+
+std::string read_chunks(std::string const& file_name, unsigned threads)
+{
+   LineReader reader(file_name, threads);
+   std::string text;
+   for (LineReader::chunk chunk; reader.read_chunk(1000, &chunk);) {
+      CHECK(chunk.lines().back() == '\n');
+      text.append(chunk.lines());
+   }
+   return text;
+}
+
+std::string numbered_lines(int count)
+{
+   std::string text;
+   for (int i = 0; i < count; ++i) {
+      text += "line " + std::to_string(i) + " of a compressed log\n";
+   }
+   return text;
+}
+
+#if defined(LOGALIZER_WITH_ZLIB)
+/**
+ * @brief Compress data into one bgzip block, as bgzip writes blocks of at most 64 KiB of text
+ *
+ */
+std::string bgzf_block(std::string_view data)
+{
+   std::string deflated(compressBound(static_cast<uLong>(data.size())) + 64, '\0');
+   z_stream stream{};
+   deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+   stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+   stream.avail_in = static_cast<uInt>(data.size());
+   stream.next_out = reinterpret_cast<Bytef*>(deflated.data());
+   stream.avail_out = static_cast<uInt>(deflated.size());
+   deflate(&stream, Z_FINISH);
+   deflated.resize(stream.total_out);
+   deflateEnd(&stream);
+
+   auto little_endian = [](std::string* out, std::size_t value, int bytes) {
+      for (int i = 0; i < bytes; ++i, value >>= 8U) {
+         out->push_back(static_cast<char>(value & 0xFFU));
+      }
+   };
+   std::string member("\x1f\x8b\x08\x04\0\0\0\0\0\xff\x06\0BC\x02\0", 16);
+   little_endian(&member, 18 + deflated.size() + 8 - 1, 2);
+   member += deflated;
+   little_endian(&member, crc32(0, reinterpret_cast<const Bytef*>(data.data()), static_cast<uInt>(data.size())), 4);
+   little_endian(&member, data.size(), 4);
+   return member;
+}
+#endif
+}  // namespace
+
+TEST_CASE("Compressed files are detected and read line by line")
+{
+   const std::string file = (fs::temp_directory_path() / "compressed.log").string();
+   // more than one compressed block, zstd blocks are decoded in parallel
+   const std::string text = numbered_lines(200000);
+
+   std::ofstream(file, std::ios::binary) << text;
+   CHECK(detect_compression(file) == compression::none);
+
+   for (const auto format : {compression::gzip, compression::zstd, compression::lz4}) {
+      if (!is_supported(format)) {
+         continue;
+      }
+      INFO(to_string(format));
+      write_compressed(file, text, format);
+      CHECK(detect_compression(file) == format);
+      CHECK(fs::file_size(file) < text.size() / 4);
+      CHECK(LineReader(file).compressed() == format);
+      CHECK(read_lines(file, 1) == text);
+      CHECK(read_lines(file, 4) == text);
+      CHECK(read_chunks(file, 4) == text);
+
+      // members and frames joined with cat, the last line without a line terminator
+      write_compressed(file, "first\nsec", format);
+      write_compressed(file, "ond\nlast", format, std::ios::app);
+      CHECK(read_lines(file, 2) == "first\nsecond\nlast\n");
+
+      LineReader reader(file);
+      std::string_view line;
+      REQUIRE(reader.seek(6));
+      REQUIRE(reader.getline(&line));
+      CHECK(line == "second");
+   }
+}
+
+TEST_CASE("Damaged compressed files are reported")
+{
+   const std::string file = (fs::temp_directory_path() / "damaged.log").string();
+   for (const auto format : {compression::gzip, compression::zstd, compression::lz4}) {
+      if (!is_supported(format)) {
+         continue;
+      }
+      INFO(to_string(format));
+      write_compressed(file, numbered_lines(1000), format);
+      fs::resize_file(file, fs::file_size(file) - 10);
+      CHECK_THROWS_AS(read_lines(file, 1), std::runtime_error);
+   }
+}
+
+#if defined(LOGALIZER_WITH_ZLIB)
+TEST_CASE("bgzip blocks are decoded in parallel")
+{
+   const std::string file = (fs::temp_directory_path() / "bgzip.log.gz").string();
+   const std::string text = numbered_lines(50000);
+
+   // blocks of at most 64 KiB of text, followed by the empty end of file block
+   {
+      std::ofstream out(file, std::ios::binary);
+      for (std::size_t offset = 0; offset < text.size(); offset += 65280) {
+         out << bgzf_block(std::string_view(text).substr(offset, 65280));
+      }
+      out << bgzf_block({});
+   }
+
+   CHECK(detect_compression(file) == compression::gzip);
+   CHECK(read_lines(file, 1) == text);
+   CHECK(read_lines(file, 4) == text);
+}
+
+TEST_CASE("Damaged bgzip blocks are reported")
+{
+   const std::string file = (fs::temp_directory_path() / "bgzip_damaged.log.gz").string();
+   const std::string valid = bgzf_block("a bgzip block\n");
+   auto write = [&file](std::string const& data) { std::ofstream(file, std::ios::binary) << data; };
+
+   // block sizes too small to hold the extra field and the trailer
+   for (const std::size_t size : {std::size_t{0}, std::size_t{18}, std::size_t{24}}) {
+      std::string damaged = valid;
+      damaged[16] = static_cast<char>(size & 0xFFU);
+      damaged[17] = static_cast<char>(size >> 8U);
+      write(damaged);
+      CHECK_THROWS_AS(read_lines(file, 1), std::runtime_error);
+   }
+
+   // an extra field longer than the block
+   std::string long_extra = valid;
+   long_extra[10] = '\x7f';
+   write(long_extra);
+   CHECK_THROWS_AS(read_lines(file, 1), std::runtime_error);
+
+   // a truncated block
+   write(valid.substr(0, valid.size() - 6));
+   CHECK_THROWS_AS(read_lines(file, 1), std::runtime_error);
+
+   write(valid);
+   CHECK(read_lines(file, 1) == "a bgzip block\n");
+}
+#endif
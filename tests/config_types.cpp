@@ -0,0 +1,51 @@
+#include "config_types.h"
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <vector>
+
+using namespace Logalizer::Config;
+
+namespace {
+std::string render(translation tr, std::vector<std::string> const& values)
+{
+   tr.compile_print();
+   std::string rendered;
+   for (auto const& segment : tr.print_format) {
+      rendered += (segment.variable == print_segment::no_variable) ? segment.text : values.at(segment.variable);
+   }
+   return rendered;
+}
+}  // namespace
+
+TEST_CASE("compile_print without variables keeps the print")
+{
+   translation tr;
+   tr.print = "Temperature ${1} ${count}";
+   CHECK(render(tr, {}) == "Temperature ${1} ${count}");
+}
+
+TEST_CASE("compile_print appends values when the print has no ${1}")
+{
+   translation tr;
+   tr.print = "Temperature ${2}";
+   tr.variables = {{"a", "b"}, {"c", "d"}};
+   CHECK(render(tr, {"45", "high"}) == "Temperature ${2}(45, high)");
+   tr.compile_print();
+   CHECK(tr.print_format.size() == 5);
+}
+
+TEST_CASE("compile_print replaces placeholders of existing variables")
+{
+   translation tr;
+   tr.print = "${2} - ${1} ${1}${3} ${01} ${x} ${count} ${";
+   tr.variables = {{"a", "b"}, {"c", "d"}};
+   CHECK(render(tr, {"45", "high"}) == "high - 45 45${3} ${01} ${x} ${count} ${");
+}
+
+TEST_CASE("compile_print inserts values literally")
+{
+   translation tr;
+   tr.print = "${1} and ${2}";
+   tr.variables = {{"a", "b"}, {"c", "d"}};
+   CHECK(render(tr, {"$&${2}", "x"}) == "$&${2} and x");
+}
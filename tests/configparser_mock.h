@@ -1,7 +1,11 @@
 #pragma once
+#include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 #include "configparser.h"
+#include "line_reader.h"
 #include "translator.h"
 namespace unit_test {
 
@@ -75,6 +79,11 @@ class ConfigParserMock : public Logalizer::Config::ConfigParser {
       ConfigParser::set_delete_lines_regex(std::move(delete_lines_regex));
    }
 
+   void set_delete_lines_linear(std::vector<LinearRegex> delete_lines_linear)
+   {
+      ConfigParser::set_delete_lines_linear(std::move(delete_lines_linear));
+   }
+
    void set_delete_lines(std::vector<std::string> delete_lines)
    {
       ConfigParser::set_delete_lines(std::move(delete_lines));
@@ -128,6 +137,108 @@ class TranslatorTesterProxy {
    {
       tr.replace_words(line);
    }
+   void set_threads(unsigned threads, std::size_t chunk_size)
+   {
+      tr.set_threads(threads);
+      tr.chunk_size_ = chunk_size;
+   }
+   void translate_file(std::string const &trace_file_name)
+   {
+      tr.translate_file(trace_file_name);
+   }
+   void translate_interrupted(std::string const &trace_file_name, std::size_t lines, std::size_t checkpoint_at)
+   {
+      // like translate_file killed after lines, with its last checkpoint after checkpoint_at lines
+      LineReader trace_file(trace_file_name);
+      std::ofstream trimmed_file;
+      tr.set_checkpoint_interval(0);
+      tr.start_translation(trace_file_name, trace_file, trimmed_file);
+      std::string_view line;
+      for (std::size_t number = 1; number <= lines && trace_file.getline(&line); ++number) {
+         if (tr.trim(&line)) {
+            tr.write_to_file(line, trimmed_file);
+            tr.translate(line);
+         }
+         if (number == checkpoint_at) {
+            tr.save_checkpoint(trace_file.offset(), trimmed_file);
+         }
+      }
+      trimmed_file.flush();
+      tr.translation_file_.flush();
+   }
+   void set_resume(bool resume)
+   {
+      tr.set_resume(resume);
+   }
+   void follow_update(std::string const &trace_file_name, bool start = false)
+   {
+      if (start) {
+         tr.start_follow();
+      }
+      if (tr.read_appended(trace_file_name) || start) {
+         tr.render_pending();
+      }
+   }
+   void finish_follow(std::string const &trace_file_name)
+   {
+      tr.finish_follow(trace_file_name);
+   }
+   void enable_stats()
+   {
+      tr.enable_stats();
+   }
+   [[nodiscard]] translate_stats const &get_stats() const noexcept
+   {
+      return tr.get_stats();
+   }
+   [[nodiscard]] auto get_matching_translator(std::string_view line)
+   {
+      return tr.get_matching_translator(line);
+   }
+   [[nodiscard]] static std::string_view capture_values(variable_search const &var, std::string_view content)
+   {
+      return Translator::capture_values(var, content);
+   }
+   [[nodiscard]] static std::string_view capture_values(variable const &var, std::string_view content)
+   {
+      return Translator::capture_values({LiteralSearch(var.startswith), LiteralSearch(var.endswith)}, content);
+   }
+   [[nodiscard]] std::string_view fill_values_formatted(std::vector<std::string_view> const &values,
+                                                        translation const &translation)
+   {
+      return tr.fill_values_formatted(values, translation);
+   }
+   void open_translation_file()
+   {
+      tr.open_translation_file();
+   }
+   void add_translation(std::string_view translation, duplicates_t duplicates)
+   {
+      tr.add_translation(translation, duplicates);
+   }
+   void write_translation_file()
+   {
+      tr.write_translation_file();
+   }
+   [[nodiscard]] std::string update_count(std::size_t count, std::string_view translation)
+   {
+      tr.append_translation(translation);
+      const std::size_t index = tr.flushed_ + tr.translations.size() - 1;
+      tr.add_count(index, translation).count = count;
+      std::string counted(tr.apply_count(index, translation));
+      tr.translations.clear();
+      tr.trans_count.clear();
+      return counted;
+   }
+   std::size_t validate_pairs(std::vector<std::string> const &translations)
+   {
+      std::vector<std::size_t> errors;
+      tr.pair_open_.assign(tr.config_.get_pairs().size(), false);
+      for (auto const &translation : translations) {
+         tr.check_pairs(translation, &errors);
+      }
+      return errors.size();
+   }
 
   private:
    Translator tr;
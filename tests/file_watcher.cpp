@@ -0,0 +1,46 @@
+#include "file_watcher.h"
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+TEST_CASE("FileWatcher reports a removed file")
+{
+   const std::string file = (fs::temp_directory_path() / "watched.log").string();
+   std::ofstream(file) << "first\n";
+   FileWatcher watcher(file, std::chrono::milliseconds{10});
+
+   std::ofstream(file, std::ios::app) << "second\n";
+   CHECK(watcher.wait());
+   CHECK(watcher.wait());
+
+   fs::remove(file);
+   CHECK_FALSE(watcher.wait());
+}
+
+#if !defined(_WIN32)
+TEST_CASE("FileWatcher follows a rotated file under its name")
+{
+   const std::string file = (fs::temp_directory_path() / "watched_rotated.log").string();
+   const std::string rotated = file + ".1";
+   std::ofstream(file) << "first\n";
+   FileWatcher watcher(file, std::chrono::milliseconds{10});
+   const auto identity = FileWatcher::identify(file);
+   REQUIRE(identity);
+
+   fs::rename(file, rotated);
+   std::ofstream(file) << "second\n";
+   CHECK(watcher.wait());
+   CHECK(FileWatcher::identify(file) != identity);
+
+   // the new file is watched, not the renamed one
+   std::ofstream(file, std::ios::app) << "third\n";
+   CHECK(watcher.wait());
+
+   // renamed and not created again
+   fs::rename(file, rotated);
+   CHECK_FALSE(watcher.wait());
+   fs::remove(rotated);
+}
+#endif
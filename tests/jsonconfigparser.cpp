@@ -89,7 +89,8 @@ TEST_CASE("delete_lines available")
     "delete_lines": [
       "dl1",
       "dl2",
-      "dl_regex.*"
+      "dl_regex.*",
+      "dl_[[:digit:]]"
     ]
   }
   )");
@@ -97,6 +98,7 @@ TEST_CASE("delete_lines available")
    JsonConfigParser parser(j);
    parser.load_delete_lines();
    CHECK(parser.get_delete_lines() == std::vector<std::string>({"dl1", "dl2"}));
+   CHECK(parser.get_delete_lines_linear().size() == 1);
    CHECK(parser.get_delete_lines_regex().size() == 1);
 }
 
@@ -130,6 +132,25 @@ TEST_CASE("replace_words available")
    CHECK(replacements.at(1).replace == "new2");
 }
 
+TEST_CASE("replace_words invalid regex is ignored")
+{
+   auto j = json::parse(R"(
+  {
+    "replace_words": {
+      "old(1": "new1",
+      "old.2": "new2"
+    }
+  }
+  )");
+
+   JsonConfigParser parser(j);
+   parser.load_replace_words();
+   auto replacements = parser.get_replace_words();
+   REQUIRE(replacements.size() == 1);
+   CHECK(replacements.at(0).search == "old.2");
+   CHECK_FALSE(replacements.at(0).literal);
+}
+
 TEST_CASE("replace_words unavailable")
 {
    auto j = json::parse(R"( { })");
@@ -809,7 +830,7 @@ TEST_CASE("read full configuration")
    CHECK(parser.get_wrap_text_post().size() == 2);
    CHECK(parser.get_blacklists().size() == 2);
    CHECK(parser.get_delete_lines().size() == 2);
-   CHECK(parser.get_delete_lines_regex().size() == 1);
+   CHECK(parser.get_delete_lines_linear().size() == 1);
    CHECK(parser.get_replace_words().size() == 2);
    CHECK(parser.get_execute_commands().size() == 2);
    CHECK_FALSE(parser.get_translation_file().empty());
@@ -1001,3 +1022,33 @@ TEST_CASE("translations one translation and with many pairswith")
    CHECK(pairs.at(1).before == "before");
    CHECK(pairs.at(1).error == "error print");
 }
+
+TEST_CASE("path variables are expanded again for every log")
+{
+   auto j = json::parse(R"( {
+    "translations": [
+     {
+       "patterns": ["pattern"],
+       "print": "print this message"
+     }
+    ],
+    "wrap_text_pre": ["title ${fileBasename}"],
+    "execute": ["open ${fileDirname}/${fileBasenameNoExtension}.svg"],
+    "translation_file": "${fileDirname}/${fileBasenameNoExtension}.txt",
+    "backup_file": "${fileDirname}/backup/${fileBasename}"
+  }
+  )");
+
+   JsonConfigParser parser(j);
+   parser.set_path_variables({"first", "one.log", "one"});
+   parser.load_configurations();
+   CHECK(parser.get_translation_file() == "first/one.txt");
+   CHECK(parser.get_backup_file() == "first/backup/one.log");
+
+   parser.set_path_variables({"second", "two.log", "two"});
+   CHECK(parser.get_translation_file() == "second/two.txt");
+   CHECK(parser.get_backup_file() == "second/backup/two.log");
+   CHECK(parser.get_wrap_text_pre() == std::vector<std::string>{"title two.log"});
+   CHECK(parser.get_execute_commands() == std::vector<std::string>{"open second/two.svg"});
+   CHECK(parser.get_translations().size() == 1);
+}
@@ -0,0 +1,25 @@
+#include "line_filter.h"
+#include <catch2/catch_test_macros.hpp>
+
+using namespace Logalizer::Config;
+
+TEST_CASE("LineFilter finds delete and blacklist entries in one scan")
+{
+   const LineFilter filter({"drop", "shared"}, {"hide", "shared"});
+   const unsigned both = LineFilter::deleted | LineFilter::blacklisted;
+
+   CHECK(filter.find("keep me", both) == 0);
+   CHECK(filter.find("please drop me", both) == LineFilter::deleted);
+   CHECK(filter.find("hide me", both) == LineFilter::blacklisted);
+   CHECK(filter.find("drop and hide", both) == both);
+   CHECK(filter.find("shared", both) == both);
+   CHECK(filter.find("drop and hide", LineFilter::blacklisted) == LineFilter::blacklisted);
+}
+
+TEST_CASE("LineFilter empty entries match every line")
+{
+   const LineFilter filter({""}, {"hide"});
+   CHECK(filter.find("", LineFilter::deleted) == LineFilter::deleted);
+   CHECK(filter.find("anything", LineFilter::deleted | LineFilter::blacklisted) == LineFilter::deleted);
+   CHECK(LineFilter().find("anything", LineFilter::deleted) == 0);
+}
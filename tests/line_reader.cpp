@@ -0,0 +1,88 @@
+#include "line_reader.h"
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+std::vector<std::string> read_all(std::string const& file_name)
+{
+   std::vector<std::string> lines;
+   LineReader reader(file_name);
+   for (std::string_view line; reader.getline(&line);) {
+      lines.emplace_back(line);
+   }
+   return lines;
+}
+
+std::vector<std::string> getline_all(std::string const& file_name)
+{
+   std::vector<std::string> lines;
+   std::ifstream file(file_name, std::ios::binary);
+   for (std::string line; std::getline(file, line, '\n');) {
+      lines.push_back(line);
+   }
+   return lines;
+}
+}  // namespace
+
+TEST_CASE("LineReader splits lines like std::getline")
+{
+   const std::string in_file = (fs::temp_directory_path() / "line_reader.log").string();
+   std::ofstream file(in_file, std::ios::binary);
+
+   SECTION("trailing new line")
+   {
+      file << "first\nsecond\n";
+   }
+
+   SECTION("no trailing new line")
+   {
+      file << "first\nsecond";
+   }
+
+   SECTION("empty lines and carriage returns are kept")
+   {
+      file << "first\r\n\r\n\nlast\r";
+   }
+
+   SECTION("empty file")
+   {
+   }
+
+   file.close();
+   LineReader reader(in_file);
+#if !defined(_WIN32)
+   CHECK(reader.is_mapped());
+#endif
+   CHECK(read_all(in_file) == getline_all(in_file));
+}
+
+TEST_CASE("LineReader views stay valid until the next line is read")
+{
+   const std::string in_file = (fs::temp_directory_path() / "line_reader.log").string();
+   std::ofstream file(in_file, std::ios::binary);
+   file << "first\nsecond\n";
+   file.close();
+
+   LineReader reader(in_file);
+   std::string_view line;
+   REQUIRE(reader.getline(&line));
+   CHECK(line == "first");
+   REQUIRE(reader.getline(&line));
+   CHECK(line == "second");
+   CHECK_FALSE(reader.getline(&line));
+   reader.close();
+   CHECK_FALSE(reader.getline(&line));
+}
+
+TEST_CASE("LineReader missing file has no lines")
+{
+   LineReader reader((fs::temp_directory_path() / "line_reader_missing.log").string());
+   std::string_view line;
+   CHECK_FALSE(reader.is_mapped());
+   CHECK_FALSE(reader.getline(&line));
+}
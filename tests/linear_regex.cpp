@@ -0,0 +1,40 @@
+#include "linear_regex.h"
+#include <catch2/catch_test_macros.hpp>
+#include <regex>
+#include <string>
+#include <vector>
+
+using namespace Logalizer::Config;
+
+TEST_CASE("LinearRegex matches like std::regex grep")
+{
+   const std::vector<std::string> patterns = {
+       "a.c",      "ab*c",   "^ab",      "bc$",       "^abc$",    "x*",     "^x*$",   "a.*c",   "[a-c]x",
+       "[^a-c]x",  "[]a]x",  "[^]a]x",   "[a-]x",     "\\.\\*",   "a\\$",   "\\^a",   "\\\\a",  "a+b?|(c){d}",
+       "]",        "a**b",   "\\.*x",    "eta.*iota", "^.*$",     "a.b.*c", "[0-9][0-9]*ms$"};
+   const std::vector<std::string> lines = {
+       "",          "abc",     "ac",      "abbbc",    "xbc",       "zabc",    "ab",     "bx",    "dx",
+       "]x",        "-x",      ".*",      "a$",       "^a",        "\\a",     "a+b?|(c){d}",  "]",
+       "aab",       "x",       "zeta iota", "a\nb c", std::string("a\0c", 3), "took 12ms", "took ms"};
+
+   for (auto const& pattern : patterns) {
+      const auto linear = LinearRegex::compile(pattern);
+      REQUIRE(linear.has_value());
+      const std::regex regex(pattern, std::regex_constants::grep | std::regex_constants::nosubs);
+      for (auto const& line : lines) {
+         INFO(pattern << " on " << line);
+         CHECK(linear->search(line) == std::regex_search(line, regex));
+      }
+   }
+}
+
+TEST_CASE("LinearRegex rejects what it cannot run in linear time")
+{
+   const std::vector<std::string> patterns = {"*a",  "\\(a\\)\\1", "a\\{2\\}", "a^b", "a$b", "[[:alpha:]]",
+                                              "[a-c-e]", "[\\]", "[abc", "a\\", std::string(64, 'a')};
+   for (auto const& pattern : patterns) {
+      INFO(pattern);
+      CHECK_FALSE(LinearRegex::compile(pattern).has_value());
+   }
+   CHECK(LinearRegex::compile(std::string(63, 'a')).has_value());
+}
@@ -0,0 +1,50 @@
+#include "literal_search.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Logalizer::Config;
+
+TEST_CASE("LiteralSearch finds what std::string_view::find finds")
+{
+   // a small alphabet makes many candidates, texts longer than a block reach the block compare
+   const std::vector<std::string> needles = {"", "a", "ab", "aa", "aba", "baab", "abcab", "aaaab", "hgfedcba", "..",
+                                             std::string(40, 'a') + "b"};
+   const std::string alphabet = "abcdefgh.";
+   std::uint32_t seed = 11;
+   for (int round = 0; round < 300; ++round) {
+      std::string text;
+      for (int i = 0; i < round; ++i) {
+         seed = seed * 1103515245U + 12345U;
+         text += alphabet[(seed >> 16U) % (round % 2 == 0 ? 2 : alphabet.size())];
+      }
+      for (auto const& needle : needles) {
+         const LiteralSearch search(needle);
+         const std::string_view view(text);
+         for (std::size_t from = 0; from <= text.size() + 1; from += 7) {
+            CHECK(search.find(view, from) == view.find(needle, from));
+         }
+         CHECK(search.in(view) == (view.find(needle) != std::string_view::npos));
+      }
+   }
+}
+
+TEST_CASE("LiteralSearch finds the needle at the end of a text")
+{
+   const LiteralSearch search("end");
+   const std::string text = std::string(100, 'e') + "end";
+   CHECK(search.find(text) == 100);
+   CHECK(search.find(text, 101) == std::string_view::npos);
+   CHECK(search.find(std::string_view(text).substr(0, 102)) == std::string_view::npos);
+   CHECK(search.needle() == "end");
+}
+
+TEST_CASE("Default LiteralSearch searches for an empty needle")
+{
+   const LiteralSearch search;
+   CHECK(search.find("text") == 0);
+   CHECK(search.find("text", 4) == 4);
+   CHECK(search.find("text", 5) == std::string_view::npos);
+}
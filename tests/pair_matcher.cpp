@@ -0,0 +1,34 @@
+#include "pair_matcher.h"
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+using namespace Logalizer::Config;
+
+TEST_CASE("PairMatcher finds roles of all pairs in one scan")
+{
+   const PairMatcher matcher({{"open", "close", "open", "e0"}, {"start", "close", "end", "e1"}});
+   PairMatcher::scratch work;
+
+   matcher.find("open and close", work);
+   CHECK(work.found == std::vector<std::uint32_t>{0, 1});
+   CHECK(work.roles[0] == (PairMatcher::source | PairMatcher::pairswith | PairMatcher::before));
+   CHECK(work.roles[1] == PairMatcher::pairswith);
+
+   matcher.find("the end", work);
+   CHECK(work.found == std::vector<std::uint32_t>{1});
+   CHECK(work.roles[0] == 0);
+   CHECK(work.roles[1] == PairMatcher::before);
+
+   matcher.find("nothing", work);
+   CHECK(work.found.empty());
+}
+
+TEST_CASE("PairMatcher empty strings are found in every line")
+{
+   const PairMatcher matcher({{"open", "close", "", "e0"}});
+   PairMatcher::scratch work;
+
+   matcher.find("", work);
+   CHECK(work.found == std::vector<std::uint32_t>{0});
+   CHECK(work.roles[0] == PairMatcher::before);
+}
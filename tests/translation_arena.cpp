@@ -0,0 +1,51 @@
+#include "translation_arena.h"
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <vector>
+
+TEST_CASE("TranslationArena keeps texts in order until they are removed")
+{
+   TranslationArena arena;
+   CHECK(arena.empty());
+   std::vector<std::string> expected;
+   for (int i = 0; i < 20000; ++i) {
+      expected.push_back("translation " + std::to_string(i));
+      arena.push_back(expected.back());
+   }
+   REQUIRE(arena.size() == expected.size());
+   CHECK(arena.back() == expected.back());
+   const std::string_view kept = arena[15000];
+
+   arena.erase_front(10000);
+   REQUIRE(arena.size() == 10000);
+   for (std::size_t i = 0; i < arena.size(); ++i) {
+      CHECK(arena[i] == expected[10000 + i]);
+   }
+   // removing texts in front does not move the others
+   CHECK(arena[5000].data() == kept.data());
+
+   arena.push_back("");
+   CHECK(arena.back().empty());
+   arena.erase_front(arena.size());
+   CHECK(arena.empty());
+   arena.push_back("again");
+   CHECK(arena[0] == "again");
+}
+
+TEST_CASE("TranslationArena stores texts longer than a block")
+{
+   TranslationArena arena;
+   const std::string longer(TranslationArena::block_size + 10, 'x');
+   arena.push_back("short");
+   arena.push_back(longer);
+   arena.push_back("after");
+   CHECK(arena[0] == "short");
+   CHECK(arena[1] == longer);
+   CHECK(arena[2] == "after");
+   arena.erase_front(2);
+   CHECK(arena[0] == "after");
+   arena.clear();
+   CHECK(arena.empty());
+   arena.push_back(longer);
+   CHECK(arena.back() == longer);
+}
@@ -0,0 +1,78 @@
+#include "translation_matcher.h"
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Logalizer::Config;
+
+namespace {
+translation make_translation(std::vector<std::string> patterns)
+{
+   translation tr;
+   tr.patterns = std::move(patterns);
+   tr.compile_search();
+   return tr;
+}
+
+std::size_t find_first(std::vector<translation> const& translations, std::string_view line)
+{
+   auto found = std::find_if(cbegin(translations), cend(translations), [&line](auto const& tr) { return tr.in(line); });
+   return static_cast<std::size_t>(std::distance(cbegin(translations), found));
+}
+}  // namespace
+
+TEST_CASE("TranslationMatcher keeps configuration order")
+{
+   const std::vector<translation> translations = {make_translation({"Temperature", "= 45"}),
+                                                  make_translation({"Temperature"}),
+                                                  make_translation({"Humidity", "Temperature"})};
+   const TranslationMatcher matcher(translations);
+   TranslationMatcher::scratch work;
+
+   CHECK(matcher.find("Temperature = 45C", work) == 0);
+   CHECK(matcher.find("Temperature = 40C", work) == 1);
+   CHECK(matcher.find("Humidity and Temperature", work) == 1);
+   CHECK(matcher.find("Humidity", work) == 3);
+   CHECK(matcher.find("", work) == 3);
+}
+
+TEST_CASE("TranslationMatcher repeated and empty patterns")
+{
+   const std::vector<translation> translations = {make_translation({"a", "a"}), make_translation({"b", ""}),
+                                                  make_translation({}), make_translation({"c"})};
+   const TranslationMatcher matcher(translations);
+   TranslationMatcher::scratch work;
+
+   CHECK(matcher.find("a", work) == 0);
+   CHECK(matcher.find("b", work) == 1);
+   CHECK(matcher.find("c", work) == 2);
+}
+
+TEST_CASE("TranslationMatcher matches translation::in")
+{
+   std::mt19937 rng(7);
+   const std::vector<std::string> words = {"ab", "abc", "bc", "cab", "x", "yz", "zz", "abcab"};
+   auto pick = [&](std::size_t n) { return words[std::uniform_int_distribution<std::size_t>(0, n - 1)(rng)]; };
+
+   std::vector<translation> translations;
+   for (int i = 0; i < 40; ++i) {
+      std::vector<std::string> patterns;
+      for (int p = 0, n = 1 + i % 3; p < n; ++p) {
+         patterns.push_back(pick(words.size()));
+      }
+      translations.push_back(make_translation(patterns));
+   }
+   const TranslationMatcher matcher(translations);
+   TranslationMatcher::scratch work;
+
+   for (int i = 0; i < 2000; ++i) {
+      std::string line;
+      for (int w = 0, n = i % 6; w < n; ++w) {
+         line += pick(words.size());
+         line += (i % 2) ? " " : "";
+      }
+      CHECK(matcher.find(line, work) == find_first(translations, line));
+   }
+}
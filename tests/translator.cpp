@@ -4,7 +4,14 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "compression.h"
 #include "configparser_mock.h"
+#include "line_reader.h"
 #include "spdlog/sinks/stdout_color_sinks.h"
 #include "spdlog/spdlog.h"
 
@@ -12,6 +19,43 @@ namespace fs = std::filesystem;
 using namespace Logalizer::Config;
 using namespace unit_test;
 
+namespace {
+/**
+ * @brief Path of name in a directory of this test run, runs at the same time do not share their files
+ *
+ */
+std::string temp_file(std::string const& name)
+{
+   static const fs::path dir = [] {
+      std::random_device random;
+      fs::path run_dir;
+      do {
+         run_dir = fs::temp_directory_path() / ("logalizer_translator_" + std::to_string(random()));
+      } while (!fs::create_directories(run_dir));
+      return run_dir;
+   }();
+   return (dir / name).string();
+}
+
+std::vector<std::string> read_lines(std::string const& file_name)
+{
+   std::ifstream read_file(file_name);
+   std::vector<std::string> lines;
+   for (std::string read_line; getline(read_file, read_line);) {
+      lines.push_back(read_line);
+   }
+   return lines;
+}
+
+std::string read_all(std::string const& file_name)
+{
+   std::ifstream read_file(file_name, std::ios::binary);
+   std::stringstream content;
+   content << read_file.rdbuf();
+   return content.str();
+}
+}  // namespace
+
 TEST_CASE("is_blacklisted")
 {
    ConfigParserMock config;
@@ -39,6 +83,7 @@ TEST_CASE("is_deleted")
        " _r.*x_ ", std::regex_constants::grep | std::regex_constants::nosubs | std::regex_constants::optimize)};
    config.set_delete_lines(deleted);
    config.set_delete_lines_regex(deleted_regex);
+   config.set_delete_lines_linear({*LinearRegex::compile("^linear [0-9]*$")});
 
    TranslatorTesterProxy tr(Translator{config});
    std::string line;
@@ -46,6 +91,9 @@ TEST_CASE("is_deleted")
    line = "this is a text for _regex_ testing";
    CHECK(tr.is_deleted(line));
 
+   line = "linear 42";
+   CHECK(tr.is_deleted(line));
+
    line = "this is some text with d1";
    CHECK(tr.is_deleted(line));
 
@@ -72,16 +120,31 @@ TEST_CASE("replace")
    CHECK(line == expected);
 }
 
+TEST_CASE("replace literal and regex searches")
+{
+   ConfigParserMock config;
+   std::vector<replacement> replacements = {{"aa", "a"}, {"[0-9]+", "N"}, {"id", "$&_$&"}, {"x", "xx"}};
+   config.set_replace_words(replacements);
+   CHECK(config.get_replace_words().at(0).literal);
+   CHECK_FALSE(config.get_replace_words().at(1).literal);
+   CHECK_FALSE(config.get_replace_words().at(2).literal);
+   CHECK(config.get_replace_words().at(3).literal);
+
+   TranslatorTesterProxy tr(Translator{config});
+   std::string line = "aaaaa id 42 x 7";
+   tr.replace(&line);
+   CHECK(line == "aaa id_id N xx N");
+}
+
 TEST_CASE("translate basic patterns and print with manual variable capture")
 {
-   std::string tr_file = (fs::temp_directory_path() / "tr.txt").string();
-   std::string in_file = (fs::temp_directory_path() / "input.log").string();
+   std::string tr_file = temp_file("tr.txt");
+   std::string in_file = temp_file("input.log");
    std::ofstream file(in_file);
    ConfigParserMock config;
    config.set_translation_file(tr_file);
    std::vector<translation> translations;
    Translator tor(config);
-   std::string read_line;
    std::vector<std::string> lines;
 
    SECTION("Single pattern and print")
@@ -94,9 +157,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       translations.push_back(tr);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      getline(read_file, read_line);
-      CHECK(read_line == "TemperatureChanged");
+      CHECK(read_lines(tr_file) == std::vector<std::string>{"TemperatureChanged"});
    }
 
    SECTION("Multiple patterns and print")
@@ -109,9 +170,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       translations.push_back(tr);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      getline(read_file, read_line);
-      CHECK(read_line == "TemperatureChanged");
+      CHECK(read_lines(tr_file) == std::vector<std::string>{"TemperatureChanged"});
    }
 
    SECTION("Auto variable capture")
@@ -125,9 +184,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       translations.push_back(tr);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      getline(read_file, read_line);
-      CHECK(read_line == "Temperature(45)");
+      CHECK(read_lines(tr_file) == std::vector<std::string>{"Temperature(45)"});
    }
 
    SECTION("Auto variable capture with empty end point that captures till the end")
@@ -141,9 +198,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       translations.push_back(tr);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      getline(read_file, read_line);
-      CHECK(read_line == "Temperature(45Celcius)");
+      CHECK(read_lines(tr_file) == std::vector<std::string>{"Temperature(45Celcius)"});
    }
 
    SECTION("Auto variable capture with endline as end point that captures till the end")
@@ -157,9 +212,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       translations.push_back(tr);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      getline(read_file, read_line);
-      CHECK(read_line == "Temperature(45Celcius)");
+      CHECK(read_lines(tr_file) == std::vector<std::string>{"Temperature(45Celcius)"});
    }
    SECTION("Auto variable capture with no matching end point that captures till the end")
    {
@@ -172,9 +225,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       translations.push_back(tr);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      getline(read_file, read_line);
-      CHECK(read_line == "Temperature(45Celcius)");
+      CHECK(read_lines(tr_file) == std::vector<std::string>{"Temperature(45Celcius)"});
    }
 
    SECTION("Manual variable capture")
@@ -188,9 +239,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       translations.push_back(tr);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      getline(read_file, read_line);
-      CHECK(read_line == "Temperature is 45 degrees");
+      CHECK(read_lines(tr_file) == std::vector<std::string>{"Temperature is 45 degrees"});
    }
 
    SECTION("Auto multi variable capture")
@@ -204,9 +253,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       translations.push_back(tr);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      getline(read_file, read_line);
-      CHECK(read_line == "Temperature(45, HighTemp)");
+      CHECK(read_lines(tr_file) == std::vector<std::string>{"Temperature(45, HighTemp)"});
    }
 
    SECTION("Auto multi variable capture out of order variables")
@@ -220,9 +267,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       translations.push_back(tr);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      getline(read_file, read_line);
-      CHECK(read_line == "Temperature(HighTemp, 45)");
+      CHECK(read_lines(tr_file) == std::vector<std::string>{"Temperature(HighTemp, 45)"});
    }
 
    SECTION("Manual multi variable capture out of order variables")
@@ -236,9 +281,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       translations.push_back(tr);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      getline(read_file, read_line);
-      CHECK(read_line == "Temperature(45 - HighTemp)");
+      CHECK(read_lines(tr_file) == std::vector<std::string>{"Temperature(45 - HighTemp)"});
    }
 
    SECTION("Variable capture with missing variables")
@@ -252,9 +295,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       translations.push_back(tr);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      getline(read_file, read_line);
-      CHECK(read_line == "Temperature( ,  )");
+      CHECK(read_lines(tr_file) == std::vector<std::string>{"Temperature( ,  )"});
    }
    SECTION("duplicates: default(allowed)")
    {
@@ -267,10 +308,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       translations.push_back(tr);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      for (std::string read_line; getline(read_file, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(tr_file);
       CHECK(lines.size() == 2);
       CHECK(lines.at(0) == "TemperatureChanged");
       CHECK(lines.at(1) == "TemperatureChanged");
@@ -288,10 +326,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       translations.push_back(tr);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      for (std::string read_line; getline(read_file, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(tr_file);
       CHECK(lines.size() == 2);
       CHECK(lines.at(0) == "TemperatureChanged");
       CHECK(lines.at(1) == "TemperatureChanged");
@@ -309,14 +344,33 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       translations.push_back(tr);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      for (std::string read_line; getline(read_file, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(tr_file);
       CHECK(lines.size() == 1);
       CHECK(lines.at(0) == "TemperatureChanged");
    }
 
+   SECTION("duplicates: remove and count against earlier entries")
+   {
+      file << "a=1;\na=2;\na=1;\nb=1;\na=2;\nb=1;\na=3;\n";
+      file.close();
+      translation tr_a;
+      tr_a.patterns = {"a="};
+      tr_a.print = "${1}";
+      tr_a.variables = {{"a=", ";"}};
+      tr_a.duplicates = duplicates_t::remove;
+      translation tr_b;
+      tr_b.patterns = {"b="};
+      tr_b.print = "2";
+      tr_b.duplicates = duplicates_t::count;
+      translations.push_back(tr_a);
+      translations.push_back(tr_b);
+      config.set_wrap_text_pre({"3"});
+      config.set_translations(translations);
+      tor.translate_file(in_file);
+      lines = read_lines(tr_file);
+      CHECK(lines == std::vector<std::string>{"3", "1", "2"});
+   }
+
    SECTION("duplicates: remove_continuous")
    {
       file << "[INFO]: TemperatureSensor: temperature = 45C\n";
@@ -329,10 +383,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       translations.push_back(tr);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      for (std::string read_line; getline(read_file, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(tr_file);
       CHECK(lines.size() == 1);
       CHECK(lines.at(0) == "TemperatureChanged");
    }
@@ -350,10 +401,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       translations.push_back(tr);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      for (std::string read_line; getline(read_file, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(tr_file);
       CHECK(lines.size() == 2);
       CHECK(lines.at(0) == "Temperature(45)");
       CHECK(lines.at(1) == "Temperature(49)");
@@ -375,10 +423,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       translations.push_back(tr);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      for (std::string read_line; getline(read_file, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(tr_file);
       CHECK(lines.size() == 3);
       CHECK(lines.at(0) == "Temperature(45)");
       CHECK(lines.at(1) == "Temperature(49)");
@@ -398,10 +443,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       translations.push_back(tr);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      for (std::string read_line; getline(read_file, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(tr_file);
       CHECK(lines.size() == 1);
       CHECK(lines.at(0) == "TemperatureChanged 3 times");
    }
@@ -420,10 +462,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       translations.push_back(tr);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      for (std::string read_line; getline(read_file, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(tr_file);
       CHECK(lines.size() == 2);
       CHECK(lines.at(0) == "TemperatureChanged to 45 1 times");
       CHECK(lines.at(1) == "TemperatureChanged to 49 2 times");
@@ -443,10 +482,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       translations.push_back(tr);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      for (std::string read_line; getline(read_file, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(tr_file);
       CHECK(lines.size() == 1);
       CHECK(lines.at(0) == "Sensor values changed");
    }
@@ -466,10 +502,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       translations.push_back(tr);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      for (std::string read_line; getline(read_file, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(tr_file);
       CHECK(lines.size() == 3);
       CHECK(lines.at(0) == "TemperatureChanged");
       CHECK(lines.at(1) == "TemperatureChanged");
@@ -497,10 +530,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       translations.push_back(tr);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      for (std::string read_line; getline(read_file, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(tr_file);
       CHECK(lines.size() == 2);
       CHECK(lines.at(0) == "TemperatureChangedPressureChanged");
       CHECK(lines.at(1) == "HumidityChanged");
@@ -518,10 +548,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       translations.push_back(tr);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      for (std::string read_line; getline(read_file, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(tr_file);
       CHECK(lines.size() == 3);
       CHECK(lines.at(0) == "pre1");
       CHECK(lines.at(1) == "pre2");
@@ -540,10 +567,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       translations.push_back(tr);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      for (std::string read_line; getline(read_file, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(tr_file);
       CHECK(lines.size() == 3);
       CHECK(lines.at(0) == "TemperatureChanged");
       CHECK(lines.at(1) == "post1");
@@ -566,17 +590,10 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       config.set_delete_lines_regex({std::regex("Pres.*: ")});
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      std::ifstream in_file_read(in_file);
-      for (std::string read_line; getline(in_file_read, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(in_file);
       CHECK(lines.size() == 1);
       CHECK(lines.at(0) == "[INFO]: HumiditySensor: humidity = 20%");
-      lines.clear();
-      for (std::string read_line; getline(read_file, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(tr_file);
       CHECK(lines.size() == 1);
       CHECK(lines.at(0) == "Sensor values changed");
    }
@@ -594,18 +611,11 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       config.set_replace_words({{"state = 30", "state = Very_High_Temp"}, {"state = 3", "state = High_Temp"}});
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      std::ifstream in_file_read(in_file);
-      for (std::string read_line; getline(in_file_read, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(in_file);
       CHECK(lines.size() == 2);
       CHECK(lines.at(0) == "[INFO]: TemperatureSensor: temperature = 45C state = High_Temp");
       CHECK(lines.at(1) == "[INFO]: TemperatureSensor: temperature = 59C state = Very_High_Temp");
-      lines.clear();
-      for (std::string read_line; getline(read_file, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(tr_file);
       CHECK(lines.size() == 2);
       CHECK(lines.at(0) == "Temperature(High_Temp)");
       CHECK(lines.at(1) == "Temperature(Very_High_Temp)");
@@ -624,18 +634,11 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       config.set_replace_words({{"state = 1", "state = Very_High_Temp"}, {"state = 10", "state = High_Temp"}});
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      std::ifstream in_file_read(in_file);
-      for (std::string read_line; getline(in_file_read, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(in_file);
       CHECK(lines.size() == 2);
       CHECK(lines.at(0) == "[INFO]: TemperatureSensor: temperature = 45C state = Very_High_Temp");
       CHECK(lines.at(1) == "[INFO]: TemperatureSensor: temperature = 59C state = Very_High_Temp0");
-      lines.clear();
-      for (std::string read_line; getline(read_file, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(tr_file);
       CHECK(lines.size() == 2);
       CHECK(lines.at(0) == "Temperature(Very_High_Temp)");
       CHECK(lines.at(1) == "Temperature(Very_High_Temp0)");
@@ -654,18 +657,11 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       config.set_replace_words({{"state = 10", "state = Very_High_Temp"}, {"state = 1", "state = High_Temp"}});
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      std::ifstream in_file_read(in_file);
-      for (std::string read_line; getline(in_file_read, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(in_file);
       CHECK(lines.size() == 2);
       CHECK(lines.at(0) == "[INFO]: TemperatureSensor: temperature = 45C state = High_Temp");
       CHECK(lines.at(1) == "[INFO]: TemperatureSensor: temperature = 59C state = Very_High_Temp");
-      lines.clear();
-      for (std::string read_line; getline(read_file, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(tr_file);
       CHECK(lines.size() == 2);
       CHECK(lines.at(0) == "Temperature(High_Temp)");
       CHECK(lines.at(1) == "Temperature(Very_High_Temp)");
@@ -702,10 +698,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       config.set_pairs(pairs);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      for (std::string read_line; getline(read_file, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(tr_file);
       CHECK(lines.size() == 4);
       CHECK(lines.at(0) == "A -> B: Hi");
       CHECK(lines.at(1) == "some");
@@ -740,10 +733,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       config.set_pairs(pairs);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      for (std::string read_line; getline(read_file, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(tr_file);
       CHECK(lines.size() == 2);
       CHECK(lines.at(0) == "A -> B: Hi");
       CHECK(lines.at(1) == "B -> A: Responded");
@@ -777,10 +767,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       config.set_pairs(pairs);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      for (std::string read_line; getline(read_file, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(tr_file);
       CHECK(lines.size() == 4);
       CHECK(lines.at(0) == "A -> B: Hi");
       CHECK(lines.at(1) == "error print");
@@ -816,10 +803,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       config.set_pairs(pairs);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      for (std::string read_line; getline(read_file, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(tr_file);
       CHECK(lines.size() == 4);
       CHECK(lines.at(0) == "A -> B: Hi");
       CHECK(lines.at(1) == "error print");
@@ -853,10 +837,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       config.set_pairs(pairs);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      for (std::string read_line; getline(read_file, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(tr_file);
       CHECK(lines.size() == 2);
       CHECK(lines.at(0) == "A -> B: Hi");
       CHECK(lines.at(1) == "error print");
@@ -889,10 +870,7 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       config.set_pairs(pairs);
       config.set_translations(translations);
       tor.translate_file(in_file);
-      std::ifstream read_file(tr_file);
-      for (std::string read_line; getline(read_file, read_line);) {
-         lines.push_back(read_line);
-      }
+      lines = read_lines(tr_file);
       CHECK(lines.size() == 4);
       CHECK(lines.at(0) == "A -> B: Hi");
       CHECK(lines.at(1) == "error print");
@@ -900,3 +878,546 @@ TEST_CASE("translate basic patterns and print with manual variable capture")
       CHECK(lines.at(3) == "error print");
    }
 }
+
+TEST_CASE("translate with threads keeps input order")
+{
+   const std::string tr_file = temp_file("tr_threads.txt");
+   ConfigParserMock config;
+   config.set_translation_file(tr_file);
+   config.set_delete_lines({"drop"});
+   config.set_replace_words({{"state", "STATE"}});
+
+   translation counted;
+   counted.patterns = {"tick"};
+   counted.print = "tick ${count}";
+   counted.duplicates = duplicates_t::count_continuous;
+   translation removed;
+   removed.patterns = {"value"};
+   removed.print = "value";
+   removed.variables = {{"value=", ";"}};
+   removed.duplicates = duplicates_t::remove;
+   translation allowed;
+   allowed.patterns = {"STATE"};
+   allowed.print = "${1}";
+   allowed.variables = {{"STATE=", ""}};
+   config.set_translations({counted, removed, allowed});
+
+   std::string input;
+   for (int i = 0; i < 500; ++i) {
+      input += (i % 7 == 0) ? "drop this\n" : "";
+      input += (i % 3 == 0) ? "tick\r\n" : "";
+      input += "value=" + std::to_string(i % 11) + "; state=" + std::to_string(i % 5) + "\n";
+   }
+   input += "tick";
+
+   auto translate = [&](unsigned threads, std::string const& name) {
+      const std::string in_file = temp_file(name);
+      std::ofstream(in_file, std::ios::binary) << input;
+      TranslatorTesterProxy tor(Translator{config});
+      tor.set_threads(threads, 64);
+      tor.translate_file(in_file);
+      return read_all(in_file) + "---\n" + read_all(tr_file);
+   };
+
+   const std::string single = translate(1, "input_single.log");
+   CHECK(single.find("drop") == std::string::npos);
+   CHECK(single.find("tick 1") != std::string::npos);
+   CHECK(translate(4, "input_threads.log") == single);
+}
+
+TEST_CASE("pair errors are inserted before the line they were found at")
+{
+   const std::string tr_file = temp_file("tr_pairs.txt");
+   const std::string in_file = temp_file("input_pairs.log");
+   std::ofstream(in_file) << "S1\nS2\nX\nS1\nE\n";
+
+   ConfigParserMock config;
+   config.set_translation_file(tr_file);
+   std::vector<translation> translations;
+   for (std::string const text : {"S1", "S2", "X", "E"}) {
+      translation tr;
+      tr.patterns = {text};
+      tr.print = text;
+      translations.push_back(tr);
+   }
+   config.set_translations(translations);
+   config.set_pairs({{"S1", "P1", "E", "err0"}, {"S2", "P2", "X", "err1"}, {"X", "P3", "", "err2"}});
+
+   Translator tor(config);
+   tor.translate_file(in_file);
+   CHECK(read_lines(tr_file) == std::vector<std::string>{"S1", "S2", "err1", "X", "err0", "err2", "S1", "err0", "E"});
+}
+
+TEST_CASE("translations are written as they become final")
+{
+   const std::string tr_file = temp_file("tr_streamed.txt");
+   const std::string in_file = temp_file("input_streamed.log");
+
+   ConfigParserMock config;
+   config.set_translation_file(tr_file);
+   translation counted;
+   counted.patterns = {"total"};
+   counted.print = "total ${count}";
+   counted.duplicates = duplicates_t::count;
+   translation start;
+   start.patterns = {"S"};
+   start.print = "S";
+   translation numbered;
+   numbered.patterns = {"line"};
+   numbered.print = "${1}";
+   numbered.variables = {{"line ", ""}};
+   config.set_translations({counted, start, numbered});
+   config.set_pairs({{"S", "P", "E", "unclosed"}});
+
+   // well beyond one flush batch, the count and the open pair stay pending until the end
+   std::string input;
+   std::vector<std::string> expected;
+   for (int i = 0; i < 3000; ++i) {
+      if (i == 1500 || i == 2999) {
+         input += "total\n";
+         if (i == 1500) expected.push_back("total 2");
+      }
+      else if (i == 100 || i == 200 || i == 2000) {
+         input += "S\n";
+         if (i != 100) expected.push_back("unclosed");
+         expected.push_back("S");
+      }
+      else {
+         input += "line " + std::to_string(i) + "\n";
+         expected.push_back(std::to_string(i));
+      }
+   }
+   expected.push_back("unclosed");
+   std::ofstream(in_file) << input;
+
+   Translator tor(config);
+   tor.translate_file(in_file);
+   CHECK(read_lines(tr_file) == expected);
+}
+
+TEST_CASE("a translation counted after it was added is held back until its count is final")
+{
+   const std::string tr_file = temp_file("tr_counted_later.txt");
+   const std::string in_file = temp_file("input_counted_later.log");
+
+   ConfigParserMock config;
+   config.set_translation_file(tr_file);
+   // the same translation from a line that is not counted and from lines that are
+   translation kept;
+   kept.patterns = {"first"};
+   kept.print = "seen ${count}";
+   kept.duplicates = duplicates_t::remove;
+   translation counted;
+   counted.patterns = {"again"};
+   counted.print = "seen ${count}";
+   counted.duplicates = duplicates_t::count;
+   translation numbered;
+   numbered.patterns = {"line"};
+   numbered.print = "${1}";
+   numbered.variables = {{"line ", ""}};
+   config.set_translations({kept, counted, numbered});
+
+   std::string lines;
+   std::vector<std::string> numbers;
+   for (int i = 0; i < 3000; ++i) {
+      lines += "line " + std::to_string(i) + "\n";
+      numbers.push_back(std::to_string(i));
+   }
+   auto translate = [&](std::string const& input) {
+      std::ofstream(in_file) << input;
+      Translator tor(config);
+      tor.translate_file(in_file);
+      return read_lines(tr_file);
+   };
+   auto expected = [&numbers](std::string const& first) {
+      std::vector<std::string> translated = {first};
+      translated.insert(end(translated), cbegin(numbers), cend(numbers));
+      return translated;
+   };
+
+   // the count starts before the first flush, the last duplicate arrives after several
+   CHECK(translate("first\nagain\n" + lines + "again\n") == expected("seen 2"));
+   // the only duplicate arrives after several flushes
+   CHECK(translate("first\n" + lines + "again\n") == expected("seen 1"));
+   // without a duplicate the ${count} is left as it is
+   CHECK(translate("first\n" + lines) == expected("seen ${count}"));
+}
+
+TEST_CASE("stats count lines and translations")
+{
+   ConfigParserMock config;
+   config.set_translation_file(temp_file("tr_stats.txt"));
+   config.set_delete_lines({"drop"});
+   config.set_blacklists({"hide"});
+   translation first;
+   first.patterns = {"first"};
+   first.print = "first";
+   translation second;
+   second.patterns = {"second"};
+   second.print = "second";
+   config.set_translations({first, second});
+
+   const std::string input = "first\ndrop\nsecond hide\nsecond\nfirst\nnone\n";
+   for (const unsigned threads : {1U, 3U}) {
+      const std::string in_file = temp_file("input_stats.log");
+      std::ofstream(in_file, std::ios::binary) << input;
+      TranslatorTesterProxy tor(Translator{config});
+      tor.set_threads(threads, 8);
+      tor.enable_stats();
+      tor.translate_file(in_file);
+
+      auto const &stats = tor.get_stats();
+      CHECK(stats.lines_read == 6);
+      CHECK(stats.lines_deleted == 1);
+      CHECK(stats.lines_blacklisted == 1);
+      CHECK(stats.lines_translated == 3);
+      CHECK(stats.bytes_in == input.size());
+      // trimmed log and "first\nsecond\nfirst\n"
+      CHECK(stats.bytes_out == input.size() - 5 + 19);
+      REQUIRE(stats.translations.size() == 2);
+      CHECK(stats.translations[0].hits == 2);
+      CHECK(stats.translations[1].hits == 1);
+
+      std::stringstream json;
+      stats.print_json(json, config.get_translations());
+      const auto report = nlohmann::json::parse(json.str());
+      CHECK(report["lines"]["translated"] == 3);
+      CHECK(report["translations"].size() == 2);
+   }
+}
+
+TEST_CASE("follow translates appended lines only")
+{
+   const std::string tr_file = temp_file("tr_follow.txt");
+   const std::string in_file = temp_file("input_follow.log");
+   ConfigParserMock config;
+   config.set_translation_file(tr_file);
+   config.set_wrap_text_pre({"@startuml"});
+   config.set_wrap_text_post({"@enduml"});
+   config.set_delete_lines({"drop"});
+   translation counted;
+   counted.patterns = {"tick"};
+   counted.print = "tick x${count}";
+   counted.duplicates = duplicates_t::count;
+   translation allowed;
+   allowed.patterns = {"event"};
+   allowed.print = "event";
+   config.set_translations({counted, allowed});
+   config.set_pairs({{"event", "P", "", "open event"}});
+
+   auto append = [&in_file](std::string const &text) {
+      std::ofstream(in_file, std::ios::binary | std::ios::app) << text;
+   };
+
+   std::ofstream(in_file, std::ios::binary) << "tick\ndrop\n";
+   TranslatorTesterProxy tor(Translator{config});
+   tor.follow_update(in_file, true);
+   CHECK(read_all(tr_file) == "@startuml\ntick x1\n@enduml\n");
+
+   // the incomplete line waits for its terminator, the held count is rendered again
+   append("event\ntick\nev");
+   tor.follow_update(in_file);
+   CHECK(read_all(tr_file) == "@startuml\ntick x2\nevent\n@enduml\n");
+
+   append("ent\n");
+   tor.follow_update(in_file);
+   CHECK(read_all(tr_file) == "@startuml\ntick x2\nevent\nopen event\nevent\n@enduml\n");
+
+   append("tick");
+   tor.finish_follow(in_file);
+   CHECK(read_all(tr_file) == "@startuml\ntick x3\nevent\nopen event\nevent\nopen event\n@enduml\n");
+   // the followed file itself is not rewritten
+   CHECK(read_all(in_file) == "tick\ndrop\nevent\ntick\nevent\ntick");
+}
+
+TEST_CASE("follow rewrites only the counts that changed")
+{
+   const std::string tr_file = temp_file("tr_follow_counts.txt");
+   const std::string in_file = temp_file("input_follow_counts.log");
+   ConfigParserMock config;
+   config.set_translation_file(tr_file);
+   config.set_wrap_text_post({"@enduml"});
+   translation counted;
+   counted.patterns = {"tick"};
+   counted.print = "tick ${count} of ${count}";
+   counted.duplicates = duplicates_t::count;
+   translation allowed;
+   allowed.patterns = {"event"};
+   allowed.print = "event";
+   config.set_translations({counted, allowed});
+
+   auto append = [&in_file](std::string const &text) {
+      std::ofstream(in_file, std::ios::binary | std::ios::app) << text;
+   };
+   auto events = [](int count) {
+      std::string text;
+      for (int i = 0; i < count; ++i) {
+         text += "event\n";
+      }
+      return text;
+   };
+
+   std::ofstream(in_file, std::ios::binary) << "tick\n" << events(50);
+   TranslatorTesterProxy tor(Translator{config});
+   tor.enable_stats();
+   tor.follow_update(in_file, true);
+   CHECK(read_all(tr_file) == "tick 1 of 1\n" + events(50) + "@enduml\n");
+
+   // nothing appended, nothing written
+   const auto bytes_out = tor.get_stats().bytes_out;
+   tor.follow_update(in_file);
+   CHECK(tor.get_stats().bytes_out == bytes_out);
+
+   // the count keeps its width, it is written over the old one and only the post text is written again
+   append("tick\n");
+   tor.follow_update(in_file);
+   CHECK(read_all(tr_file) == "tick 2 of 2\n" + events(50) + "@enduml\n");
+   CHECK(tor.get_stats().bytes_out == bytes_out + 8);
+
+   // a wider count renders everything after it again
+   append("tick\ntick\ntick\ntick\ntick\ntick\ntick\ntick\nevent\n");
+   tor.follow_update(in_file);
+   CHECK(read_all(tr_file) == "tick 10 of 10\n" + events(51) + "@enduml\n");
+
+   append("tick\n");
+   tor.finish_follow(in_file);
+   CHECK(read_all(tr_file) == "tick 11 of 11\n" + events(51) + "@enduml\n");
+}
+
+TEST_CASE("follow keeps the translations flushed while reading")
+{
+   const std::string tr_file = temp_file("tr_follow_flushed.txt");
+   const std::string in_file = temp_file("input_follow_flushed.log");
+   ConfigParserMock config;
+   config.set_translation_file(tr_file);
+   config.set_wrap_text_post({"@enduml"});
+   translation allowed;
+   allowed.patterns = {"event"};
+   allowed.print = "event ${1}";
+   allowed.variables = {{"event ", ""}};
+   config.set_translations({allowed});
+
+   // more translations per update than are held before a flush
+   std::string lines;
+   std::string expected;
+   for (int i = 0; i < 3000; ++i) {
+      lines += "event " + std::to_string(i) + "\n";
+      expected += "event " + std::to_string(i) + "\n";
+   }
+   std::ofstream(in_file, std::ios::binary) << lines;
+   TranslatorTesterProxy tor(Translator{config});
+   tor.follow_update(in_file, true);
+   std::ofstream(in_file, std::ios::binary | std::ios::app) << lines;
+   tor.follow_update(in_file);
+
+   CHECK(read_all(tr_file) == expected + expected + "@enduml\n");
+}
+
+TEST_CASE("follow reads a rotated log to its end and continues with the new one")
+{
+   const std::string tr_file = temp_file("tr_follow_rotated.txt");
+   const std::string in_file = temp_file("input_follow_rotated.log");
+   const std::string rotated_file = in_file + ".1";
+   ConfigParserMock config;
+   config.set_translation_file(tr_file);
+   translation allowed;
+   allowed.patterns = {"event"};
+   allowed.print = "event ${1}";
+   allowed.variables = {{"event ", ""}};
+   config.set_translations({allowed});
+
+
+   std::ofstream(in_file, std::ios::binary) << "event 1\n";
+   TranslatorTesterProxy tor(Translator{config});
+   tor.follow_update(in_file, true);
+   CHECK(read_all(tr_file) == "event 1\n");
+
+   // lines written to the old file after it was renamed, its last one unterminated, come before the new file
+   fs::rename(in_file, rotated_file);
+   std::ofstream(rotated_file, std::ios::binary | std::ios::app) << "event 2\nevent 3";
+   std::ofstream(in_file, std::ios::binary) << "event 4\nevent 5\n";
+   tor.follow_update(in_file);
+   CHECK(read_all(tr_file) == "event 1\nevent 2\nevent 3\nevent 4\nevent 5\n");
+
+   std::ofstream(in_file, std::ios::binary | std::ios::app) << "event 6\n";
+   tor.finish_follow(in_file);
+   CHECK(read_all(tr_file) == "event 1\nevent 2\nevent 3\nevent 4\nevent 5\nevent 6\n");
+}
+
+TEST_CASE("resume continues an interrupted translation from its checkpoint")
+{
+   const std::string tr_file = temp_file("tr_resumed.txt");
+   const std::string in_file = temp_file("input_resumed.log");
+   ConfigParserMock config;
+   config.set_translation_file(tr_file);
+   config.set_wrap_text_pre({"@startuml"});
+   config.set_wrap_text_post({"@enduml"});
+   config.set_delete_lines({"drop"});
+   translation counted;
+   counted.patterns = {"tick"};
+   counted.print = "tick x${count}";
+   counted.duplicates = duplicates_t::count;
+   translation unique;
+   unique.patterns = {"unique"};
+   unique.print = "unique ${1}";
+   unique.variables = {{"unique ", ""}};
+   unique.duplicates = duplicates_t::remove;
+   translation numbered;
+   numbered.patterns = {"line"};
+   numbered.print = "${1}";
+   numbered.variables = {{"line ", ""}};
+   config.set_translations({counted, unique, numbered});
+   config.set_pairs({{"unique", "line 7", "", "open unique"}});
+
+   std::string input;
+   for (int i = 0; i < 3000; ++i) {
+      input += (i % 500 == 0) ? "tick\n" : (i % 7 == 0) ? "drop\n" : "";
+      input += (i % 3 == 0) ? "unique " + std::to_string(i % 40) + "\n" : "line " + std::to_string(i) + "\n";
+   }
+
+   auto translate = [&](std::string const &text) {
+      std::ofstream(in_file, std::ios::binary) << text;
+      Translator(config).translate_file(in_file);
+      return std::make_pair(read_all(tr_file), read_all(in_file));
+   };
+   const auto expected = translate(input);
+
+   for (const unsigned threads : {1U, 2U}) {
+      std::ofstream(in_file, std::ios::binary) << input;
+      {
+         TranslatorTesterProxy tor(Translator{config});
+         tor.translate_interrupted(in_file, 2800, 1900);
+      }
+      REQUIRE(fs::exists(in_file + ".checkpoint"));
+
+      TranslatorTesterProxy tor(Translator{config});
+      tor.set_threads(threads, 4096);
+      tor.set_resume(true);
+      tor.translate_file(in_file);
+      CHECK(read_all(tr_file) == expected.first);
+      CHECK(read_all(in_file) == expected.second);
+      CHECK_FALSE(fs::exists(in_file + ".checkpoint"));
+   }
+
+   // a checkpoint of a different input is not used
+   const auto appended = translate(input + "line appended\n");
+   std::ofstream(in_file, std::ios::binary) << input;
+   {
+      TranslatorTesterProxy tor(Translator{config});
+      tor.translate_interrupted(in_file, 2800, 1900);
+   }
+   std::ofstream(in_file, std::ios::binary | std::ios::app) << "line appended\n";
+   TranslatorTesterProxy tor(Translator{config});
+   tor.set_resume(true);
+   tor.translate_file(in_file);
+   CHECK(read_all(tr_file) == appended.first);
+   CHECK(read_all(in_file) == appended.second);
+}
+
+TEST_CASE("compressed input is translated without rewriting it")
+{
+   const std::string tr_file = temp_file("tr_compressed.txt");
+   const std::string in_file = temp_file("input_compressed.log.gz");
+   ConfigParserMock config;
+   config.set_translation_file(tr_file);
+   config.set_delete_lines({"drop"});
+   translation numbered;
+   numbered.patterns = {"line"};
+   numbered.print = "${1}";
+   numbered.variables = {{"line ", ""}};
+   config.set_translations({numbered});
+   if (!is_supported(compression::gzip)) {
+      return;
+   }
+
+   auto write_input = [&in_file]() {
+      std::ofstream file(in_file, std::ios::binary);
+      CompressingBuffer compressed(file.rdbuf(), compression::gzip);
+      std::ostream(&compressed) << "line 1\ndrop\nline 2\n";
+   };
+
+   write_input();
+   const std::string input = read_all(in_file);
+   Translator(config).translate_file(in_file);
+   CHECK(read_all(tr_file) == "1\n2\n");
+   CHECK(read_all(in_file) == input);
+   CHECK(read_all(in_file + ".trim.log") == "line 1\nline 2\n");
+
+   fs::remove(in_file + ".trim.log");
+   Translator recompressing(config);
+   recompressing.set_compress_trimmed(true);
+   recompressing.translate_file(in_file);
+   CHECK(read_all(tr_file) == "1\n2\n");
+   CHECK_FALSE(fs::exists(in_file + ".trim.log"));
+   CHECK(detect_compression(in_file) == compression::gzip);
+   LineReader trimmed(in_file);
+   std::string_view line;
+   CHECK((trimmed.getline(&line) && line == "line 1"));
+   CHECK((trimmed.getline(&line) && line == "line 2"));
+   CHECK_FALSE(trimmed.getline(&line));
+}
+
+TEST_CASE("input is only rewritten when the configuration changes lines")
+{
+   const std::string tr_file = temp_file("tr_untouched.txt");
+   const std::string in_file = temp_file("input_untouched.log");
+   ConfigParserMock config;
+   config.set_translation_file(tr_file);
+   config.set_blacklists({"hide"});
+   translation numbered;
+   numbered.patterns = {"line"};
+   numbered.print = "${1}";
+   numbered.variables = {{"line ", ""}};
+   config.set_translations({numbered});
+
+
+   const std::string input = "line 1\r\nline 2 hide\ndrop\n\nline 3\r\ndrop\nline 4";
+   for (const unsigned threads : {1U, 2U}) {
+      std::ofstream(in_file, std::ios::binary) << input;
+      TranslatorTesterProxy tor(Translator{config});
+      tor.set_threads(threads, 8);
+      tor.translate_file(in_file);
+      CHECK(read_all(tr_file) == "1\n3\n4\n");
+      CHECK(read_all(in_file) == input);
+      CHECK_FALSE(fs::exists(in_file + ".trim.log"));
+   }
+
+   config.set_delete_lines({"drop"});
+   for (const unsigned threads : {1U, 2U}) {
+      std::ofstream(in_file, std::ios::binary) << input;
+      TranslatorTesterProxy tor(Translator{config});
+      tor.set_threads(threads, 8);
+      tor.translate_file(in_file);
+      CHECK(read_all(tr_file) == "1\n3\n4\n");
+      CHECK(read_all(in_file) == "line 1\nline 2 hide\n\nline 3\nline 4\n");
+   }
+}
+
+TEST_CASE("variables are captured as views into the line")
+{
+   const std::string line = "temp = 42C state = on;";
+   const auto value = TranslatorTesterProxy::capture_values({"= ", "C"}, line);
+   CHECK(value == "42");
+   CHECK(value.data() == line.data() + 7);
+   CHECK(TranslatorTesterProxy::capture_values({"state = ", ""}, line) == "on;");
+   CHECK(TranslatorTesterProxy::capture_values({"missing", ";"}, line) == " ");
+
+   ConfigParserMock config;
+   translation tr;
+   tr.print = "${2} at ${1}";
+   tr.variables = {{"= ", "C"}, {"state = ", ";"}};
+   config.set_translations({tr});
+   TranslatorTesterProxy tor(Translator{config});
+   const std::vector<std::string_view> values = {"42", "on"};
+   CHECK(tor.fill_values_formatted(values, config.get_translations().front()) == "on at 42");
+}
+
+TEST_CASE("counts are spliced into every ${count} of a translation")
+{
+   ConfigParserMock config;
+   TranslatorTesterProxy tor(Translator{config});
+   CHECK(tor.update_count(12, "seen ${count} times, ${count}x ${1}") == "seen 12 times, 12x ${1}");
+   CHECK(tor.update_count(3, "${count}") == "3");
+   CHECK(tor.update_count(3, "no count") == "no count");
+   CHECK(tor.update_count(3, "${coun") == "${coun");
+}